@@ -37,11 +37,11 @@
 /*
  *  Simple Build:
  *     gcc -W -Wall -O2 -c bindump.c
- *     gcc -W -Wall -O2 -o bindump   bindump.o
+ *     gcc -W -Wall -O2 -o bindump   bindump.o -lpthread
  *
  *  GNU Libtool Build:
  *     libtool --mode=compile gcc -W -Wall -g -O2 -c bindump.c
- *     libtool --mode=link    gcc -W -Wall -g -O2 -o bindump bindump.lo
+ *     libtool --mode=link    gcc -W -Wall -g -O2 -o bindump bindump.lo -lpthread
  *
  *  GNU Libtool Install:
  *     libtool --mode=install install -c bindump /usr/local/bin/bindump
@@ -62,6 +62,7 @@
 #endif
 
 #include <stdio.h>
+#include <errno.h>
 #include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
@@ -69,7 +70,10 @@
 #include <getopt.h>
 #include <sys/types.h>
 #include <sys/uio.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
+#include <pthread.h>
 
 
 ///////////////////
@@ -107,6 +111,19 @@
 #define MY_OPT_NOXTERM     0x04
 #define MY_OPT_REVERSEBIT  0x08
 
+#define MY_BLOCK_SIZE      ((size_t)(1024*1024))
+#define MY_OUTPUT_SIZE     ((size_t)(1024*1024))
+#define MY_WIDTH           8
+#define MY_WIDTH_MAX       64
+#define MY_GROUP           8
+#define MY_BITS_MAX        16
+#define MY_AREA_MAX        (MY_WIDTH_MAX * MY_BITS_MAX)
+#define MY_HEADER_MAX      (MY_AREA_MAX + MY_WIDTH_MAX + 16)
+#define MY_PATTERN_MAX     57
+#define MY_REVERT_LINE     ((size_t)(16*1024))
+#define MY_CHUNK_SIZE      ((size_t)(256*1024))
+#define MY_JOBS_MAX        256
+
 
 /////////////////
 //             //
@@ -117,6 +134,21 @@
 /// contains the state information for a file.
 typedef struct bindump_file BinDumpFile;
 
+/// buffers formatted output
+typedef struct bindump_output BinDumpOutput;
+
+/// formatted output of one chunk of a file
+typedef struct bindump_chunk BinDumpChunk;
+
+/// shared state of threads formatting a file in parallel
+typedef struct bindump_jobs BinDumpJobs;
+
+/// layout of a line of output
+typedef struct bindump_layout BinDumpLayout;
+
+/// bit pattern to locate within a file
+typedef struct bindump_pattern BinDumpPattern;
+
 
 /////////////////
 //             //
@@ -133,10 +165,92 @@ struct bindump_file
    size_t        read;        ///< number of bytes read
    ssize_t       code;        ///< return code of last file operation
    const char  * filename;    ///< name of the file
-   char          data[8];     ///< buffer for storing data for processing
+   const char  * data;        ///< data for processing within block buffer
+   char        * buff;        ///< block buffer or memory mapping of file
+   size_t        buff_size;   ///< size of block buffer
+   size_t        buff_len;    ///< number of bytes of data in block buffer
+   size_t        buff_pos;    ///< position of unprocessed data in block buffer
+   int           mapped;      ///< block buffer is a memory mapping of file
+   size_t        received;    ///< number of bytes read from file handle
+   size_t        limit;       ///< max bytes to read from file handle, 0 for no limit
+};
+
+
+/// buffers formatted output
+struct bindump_output
+{
+   int           fd;          ///< file handle to which output is flushed
+   size_t        len;         ///< number of bytes in buffer
+   size_t        size;        ///< size of buffer
+   char        * buff;        ///< buffer of formatted output
+};
+
+
+/// formatted output of one chunk of a file
+struct bindump_chunk
+{
+   int           done;        ///< 1 if formatted, -1 if formatting failed
+   BinDumpOutput out;         ///< formatted output of chunk
+};
+
+
+/// shared state of threads formatting a file in parallel
+struct bindump_jobs
+{
+   pthread_mutex_t     mutex;        ///< protects the state of chunks
+   pthread_cond_t      cond;         ///< signals changes to the state of chunks
+   const BinDumpFile * file;         ///< file being formatted
+   BinDumpChunk      * chunks;       ///< ring of chunks being formatted
+   size_t              chunk_count;  ///< number of chunks in ring
+   size_t              chunk_total;  ///< number of chunks in file
+   size_t              chunk_next;   ///< next chunk to be formatted
+   size_t              chunk_emit;   ///< next chunk to be written
+   size_t              chunk_size;   ///< number of bytes in each chunk
+   size_t              len;          ///< number of bytes to format
+   size_t              line;         ///< number of lines displayed before first chunk
+   unsigned            opts;         ///< output options
+   int                 stop;         ///< signals threads to exit
+};
+
+
+/// layout of a line of output
+struct bindump_layout
+{
+   size_t        width;                    ///< number of bytes displayed per line
+   size_t        group;                    ///< number of bits displayed per group
+   size_t        bits_len;                 ///< length of the binary notation of a byte
+   size_t        area_len;                 ///< length of the binary notation of a line
+   size_t        line_max;                 ///< max length of a formatted line
+   size_t        header_len;               ///< length of column headers
+   size_t        field[MY_WIDTH_MAX+1];    ///< start of the column of each byte
+   size_t        col[MY_WIDTH_MAX];        ///< start of the binary notation of each byte
+   char          blank[MY_AREA_MAX];       ///< template of the binary notation of a line
+   char          header[MY_HEADER_MAX];    ///< column headers
+};
+
+
+/// bit pattern to locate within a file
+struct bindump_pattern
+{
+   size_t        bits;        ///< number of bits in pattern
+   uint64_t      value[8];    ///< pattern aligned to each bit of the first byte
+   uint64_t      mask[8];     ///< bits of pattern which must match
 };
 
 
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+
+/// binary notation of each byte value in normal and reverse bit order
+static char my_bits[2][256][MY_BITS_MAX];
+
+/// layout of a line of output
+static BinDumpLayout my_layout;
+
+
 //////////////////
 //              //
 //  Prototypes  //
@@ -146,24 +260,94 @@ struct bindump_file
 // main statement
 int main PARAMS((int argc, char * argv[]));
 
+// returns the number of leading bytes which are identical in both buffers
+size_t my_cmp PARAMS((const char * buff1, const char * buff2, size_t len));
+
 // closes a file
 int my_close PARAMS((BinDumpFile * file, unsigned verbose));
 
+// reads data into block buffer until at least the requested bytes are available
+int my_fill PARAMS((BinDumpFile * file, size_t want, unsigned verbose));
+
+// converts a hex digit to an integer
+int my_hex2int PARAMS((int c));
+
+// formats the chunks of a file on behalf of the parallel dump
+void * my_jobs_thread PARAMS((void * arg));
+
 // preforms lseek on file
 int my_lseek PARAMS((BinDumpFile * file, size_t offset, unsigned verbose));
 
+// converts the output of bindump back into binary data
+int my_revert PARAMS((BinDumpOutput * out, BinDumpFile * file,
+   unsigned opts, unsigned verbose));
+
+// converts one line of the output of bindump back into binary data
+int my_revert_line PARAMS((BinDumpOutput * out, const char * line,
+   size_t len, size_t * posp, unsigned opts));
+
+// displays each location of a bit pattern within a file
+int my_search PARAMS((BinDumpOutput * out, BinDumpFile * file,
+   const BinDumpPattern * pattern, size_t len, unsigned opts,
+   unsigned verbose));
+
+// compares a bit pattern with each bit of the first byte of a window
+ssize_t my_search_window PARAMS((BinDumpOutput * out,
+   const BinDumpPattern * pattern, uint64_t window, size_t pos,
+   size_t avail));
+
+// advances both files past lines which are identical
+ssize_t my_skip PARAMS((BinDumpFile * file1, BinDumpFile * file2, size_t len,
+   size_t context, unsigned verbose));
+
 // determines the max number of bytes to dislpay
 size_t my_max PARAMS((ssize_t code, size_t len));
 
 // opens a file
-int my_open PARAMS((BinDumpFile * file, unsigned verbose));
+int my_open PARAMS((BinDumpFile * file, size_t block, unsigned verbose));
+
+// writes buffered output
+int my_out_flush PARAMS((BinDumpOutput * out));
+
+// reserves space in output buffer
+char * my_out_reserve PARAMS((BinDumpOutput * out, size_t len));
+
+// appends string to output buffer
+int my_out_str PARAMS((BinDumpOutput * out, const char * str, size_t len));
 
 // displays the diff between two files
-size_t my_print_diff PARAMS((BinDumpFile * file1, BinDumpFile * file2,
+size_t my_print_diff PARAMS((BinDumpOutput * out, BinDumpFile * file1,
+   BinDumpFile * file2, size_t offset, size_t len, unsigned opts));
+
+// displays a line which is identical in both files
+size_t my_print_context PARAMS((BinDumpOutput * out, BinDumpFile * file,
+   size_t len, unsigned opts));
+
+// displays one side of a diff
+char * my_print_diff_line PARAMS((char * ptr, char prefix, BinDumpFile * file,
+   size_t max, size_t offset, const uint8_t * diff, unsigned opts));
+
+// displays one chunk of a file
+int my_print_chunk PARAMS((BinDumpJobs * jobs, BinDumpOutput * out,
+   size_t chunk));
+
+// displays one line of data
+size_t my_print_dump PARAMS((BinDumpOutput * out, BinDumpFile * file,
    size_t offset, size_t len, unsigned opts));
 
-// displays one line 8 byte chunk of data
-size_t my_print_dump PARAMS((BinDumpFile * file, size_t offset, size_t len,
+// displays column headers
+int my_print_header PARAMS((BinDumpOutput * out, int diff, unsigned opts));
+
+// parses a bit pattern
+int my_pattern PARAMS((BinDumpPattern * pattern, const char * str));
+
+// displays a file using multiple threads
+int my_print_parallel PARAMS((BinDumpOutput * out, BinDumpFile * file,
+   size_t len, size_t * linep, unsigned jobs, unsigned opts,
+   unsigned verbose));
+
+// formats line offset
+char * my_print_offset PARAMS((char * ptr, char prefix, size_t pos,
    unsigned opts));
 
 // performs read upon file
@@ -179,6 +363,12 @@ void my_version PARAMS((void));
 // displays data in binary notation
 char * my_byte2str PARAMS((signed data, char * buff, unsigned opts));
 
+// converts binary notation of a byte into the value of the byte
+int my_str2byte PARAMS((const char * str, unsigned opts));
+
+// builds tables of binary notation and the layout of a line
+int my_init_layout PARAMS((size_t width, size_t group));
+
 
 /////////////////
 //             //
@@ -193,18 +383,30 @@ int main(int argc, char * argv[])
 {
    int         c;
    int         opt_index;
+   size_t      block;
+   size_t      context;
+   size_t      context_after;
+   size_t      context_before;
+   ssize_t     skip;
    size_t      offset;
    size_t      offset_mod;
+   size_t      width;
+   size_t      group;
    size_t      len;
    size_t      line;
    size_t      line_add;
    unsigned    opts;
+   unsigned    jobs;
    unsigned    verbose;
+   int         revert;
+   const char * search;
    BinDumpFile  file1;
    BinDumpFile  file2;
+   BinDumpOutput out;
+   BinDumpPattern pattern;
 
    // getopt options
-   static char   short_opt[] = "dhl:o:rvVx";
+   static char   short_opt[] = "b:C:dg:hj:l:o:rRs:vVw:x";
    static struct option long_opt[] =
    {
       {"help",          no_argument, 0, 'h'},
@@ -220,13 +422,23 @@ int main(int argc, char * argv[])
 #endif
 
    len          = 0;
+   block        = MY_BLOCK_SIZE;
+   context        = 0;
+   context_after  = 0;
+   context_before = 0;
    opts         = (MY_OPT_XTERM | MY_OPT_ALL);
+   jobs         = 1;
    line         = 0;
    offset       = 0;
    offset_mod   = 0;
+   width        = MY_WIDTH;
+   group        = MY_GROUP;
    verbose      = 0;
+   search       = NULL;
+   revert       = 0;
    memset(&file1, 0, sizeof(BinDumpFile));
    memset(&file2, 0, sizeof(BinDumpFile));
+   memset(&out,   0, sizeof(BinDumpOutput));
    
    while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
    {
@@ -235,28 +447,53 @@ int main(int argc, char * argv[])
          case -1:	/* no more arguments */
          case 0:	/* long options toggles */
             break;
+         case 'b':
+            block = strtoul(optarg, NULL, 0);
+            break;
+         case 'C':
+            context = strtoul(optarg, NULL, 0);
+            break;
          case 'd':
             opts = opts & (~MY_OPT_ALL);
             break;
+         case 'g':
+            group = strtoul(optarg, NULL, 0);
+            break;
          case 'h':
             my_usage();
             return(0);
+         case 'j':
+            jobs = (unsigned)strtoul(optarg, NULL, 0);
+            if ( (jobs < 1) || (jobs > MY_JOBS_MAX) )
+            {
+               fprintf(stderr, "%s: number of jobs must be between 1 and %i\n", PROGRAM_NAME, MY_JOBS_MAX);
+               return(1);
+            };
+            break;
          case 'l':
             len = strtoul(optarg, NULL, 0);
             break;
          case 'o':
             offset = strtoul(optarg, NULL, 0);
-            offset_mod = (offset % 8);
             break;
          case 'r':
             opts = opts | MY_OPT_REVERSEBIT;
             break;
+         case 'R':
+            revert = 1;
+            break;
+         case 's':
+            search = optarg;
+            break;
          case 'V':
             my_version();
             return(0);
          case 'v':
             verbose++;
             break;
+         case 'w':
+            width = strtoul(optarg, NULL, 0);
+            break;
          case 'x':
             opts = opts & (~MY_OPT_XTERM);
             break;
@@ -270,6 +507,19 @@ int main(int argc, char * argv[])
       };
    };
 
+   // computes layout of lines
+   if ((my_init_layout(width, group)))
+      return(1);
+   if (block < width)
+   {
+      fprintf(stderr, "%s: block size must be at least %zu bytes\n", PROGRAM_NAME, width);
+      return(1);
+   };
+   offset_mod = (offset % width);
+   if ((search))
+      if ((my_pattern(&pattern, search)))
+         return(1);
+
    // determines file to process (or STDIN)
    switch(argc - optind)
    {
@@ -291,15 +541,25 @@ int main(int argc, char * argv[])
    if ((file1.filename) && (file2.filename))
       if (!(strcmp(file1.filename, file2.filename)))
          file2.filename = NULL;
+   if ( (search) && (file2.filename) )
+   {
+      fprintf(stderr, "%s: unable to search two files\n", PROGRAM_NAME);
+      return(1);
+   };
+   if ( (revert) && ((file2.filename) || (search) || (offset) || (len)) )
+   {
+      fprintf(stderr, "%s: -R only accepts a single file and the layout options\n", PROGRAM_NAME);
+      return(1);
+   };
 
    // show them who we are
    if (verbose > 1)
       printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
 
    // open file for reading or set to STDIN
-   if ((my_open(&file1, verbose) == -1))
+   if ((my_open(&file1, block, verbose) == -1))
       return(my_close(&file2, verbose));
-   if ((my_open(&file2, verbose) == -1))
+   if ((my_open(&file2, block, verbose) == -1))
       return(my_close(&file1, verbose));
 
    // checks file handles for user errors
@@ -312,13 +572,6 @@ int main(int argc, char * argv[])
    };
    if (file1.fd == STDIN_FILENO)
    {
-      if (offset)
-      {
-         fprintf(stderr, PROGRAM_NAME ": unable to specify an offset with stdin\n");
-         my_close(&file1, verbose);
-         my_close(&file2, verbose);
-         return(1);
-      };
       if (file2.fd != -1)
       {
          fprintf(stderr, PROGRAM_NAME ": unable to diff stdin\n");
@@ -330,6 +583,17 @@ int main(int argc, char * argv[])
          printf("using stdin...\n");
    };
 
+   // prepares output buffer
+   out.fd   = STDOUT_FILENO;
+   out.size = MY_OUTPUT_SIZE;
+   if (!(out.buff = malloc(out.size)))
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      my_close(&file1, verbose);
+      my_close(&file2, verbose);
+      return(1);
+   };
+
    // move to the specified offset
    if (offset)
    {
@@ -341,12 +605,37 @@ int main(int argc, char * argv[])
          return(my_close(&file1, verbose));
    };
 
+   // prevents reading past the requested length from pipes
+   if ((len))
+   {
+      file1.limit = file1.received - (file1.buff_len - file1.buff_pos) + len;
+      file2.limit = file2.received - (file2.buff_len - file2.buff_pos) + len;
+   };
+
+   // converts a dump back into binary data
+   if ((revert))
+   {
+      c = my_revert(&out, &file1, opts, verbose);
+      my_out_flush(&out);
+      free(out.buff);
+      my_close(&file1, verbose);
+      return((c == -1) ? 1 : 0);
+   };
+
+   // displays the location of each match instead of the data
+   if ((search))
+   {
+      c = my_search(&out, &file1, &pattern, len, opts, verbose);
+      my_out_flush(&out);
+      free(out.buff);
+      my_close(&file1, verbose);
+      return((c == 1) ? 0 : 1);
+   };
+
    // fill in white space so the offset markings align with the position in the file
    if (verbose > 2)
       printf("reading data...\n");
-   if (file2.filename)
-      printf("  ");
-   printf("%soffset        00       01       02       03       04       05       06       07     01234567%s\n", ((opts & MY_OPT_XTERM) ? MY_TERM_BOLD : ""), ((opts & MY_OPT_XTERM) ? MY_TERM_RESET : ""));
+   my_print_header(&out, ((file2.filename)) ? 1 : 0, opts);
    if (offset_mod)
    {
       if ((my_read(&file1, offset_mod, len, verbose) == -1))
@@ -354,32 +643,62 @@ int main(int argc, char * argv[])
       if ((my_read(&file2, offset_mod, len, verbose) == -1))
          return(my_close(&file1, verbose));
       if (file2.filename)
-         line += my_print_diff(&file1, &file2, offset_mod, len, opts);
+         line += my_print_diff(&out, &file1, &file2, offset_mod, len, opts);
       else
-         line += my_print_dump(&file1, offset_mod, len, opts);
+         line += my_print_dump(&out, &file1, offset_mod, len, opts);
+   };
+
+   // formats mapped files using multiple threads
+   if ( (jobs > 1) && (file1.mapped) && (!(file2.filename)) )
+   {
+      if ((my_print_parallel(&out, &file1, len, &line, jobs, opts, verbose) == -1))
+      {
+         free(out.buff);
+         return(my_close(&file1, verbose));
+      };
    };
 
    // read data from file handle
    while ( (!(file1.eof)) || (!(file2.eof)) )
    {
+      // jumps to the next region which differs
+      if ( (file2.filename) && (!(context_after)) && (!(context_before)) )
+      {
+         if ((skip = my_skip(&file1, &file2, len, context, verbose)) == -1)
+            return(1);
+         context_before = (size_t)skip;
+      };
+
       if ((my_read(&file1, (size_t)0, len, verbose) == -1))
          return(my_close(&file2, verbose));
       if ((my_read(&file2, (size_t)0, len, verbose) == -1))
          return(my_close(&file1, verbose));
       if (file2.filename)
-         line_add = my_print_diff(&file1, &file2, (size_t)0, len, opts);
+      {
+         line_add = my_print_diff(&out, &file1, &file2, (size_t)0, len, opts);
+         if ((line_add))
+            context_after = context;
+         else if ((context_after) || (context_before))
+         {
+            line_add = my_print_context(&out, &file1, len, opts);
+            if ((context_after))
+               context_after--;
+            else
+               context_before--;
+         };
+      }
       else
-         line_add = my_print_dump(&file1, (size_t)0, len, opts);
+         line_add = my_print_dump(&out, &file1, (size_t)0, len, opts);
       line += line_add;
       if ( (!(line %  22)) && (line_add) )
-      {
-         if (file2.filename)
-            printf("  ");
-         printf("%soffset        00       01       02       03       04       05       06       07     01234567%s\n", ((opts & MY_OPT_XTERM) ? MY_TERM_BOLD : ""), ((opts & MY_OPT_XTERM) ? MY_TERM_RESET : ""));
-      };
+         my_print_header(&out, ((file2.filename)) ? 1 : 0, opts);
+      if (out.fd == -1)
+         break;
    };
 
    // close file and finish up
+   my_out_flush(&out);
+   free(out.buff);
    my_close(&file1, verbose);
    my_close(&file2, verbose);
    printf("\n");
@@ -388,6 +707,39 @@ int main(int argc, char * argv[])
 }
 
 
+/// returns the number of leading bytes which are identical in both buffers
+/// @param[in]  buff1      first buffer to compare
+/// @param[in]  buff2      second buffer to compare
+/// @param[in]  len        length of buffers
+size_t my_cmp(const char * buff1, const char * buff2, size_t len)
+{
+   size_t   pos;
+   size_t   block;
+   uint64_t word1;
+   uint64_t word2;
+
+   // compares large blocks with memcmp() until a block differs
+   for(pos = 0; pos < len; pos += block)
+   {
+      block = ((len - pos) < 4096) ? (len - pos) : 4096;
+      if ((memcmp(&buff1[pos], &buff2[pos], block)))
+         break;
+   };
+
+   // locates the difference one word at a time, then one byte at a time
+   for(; ((pos + 8) <= len); pos += 8)
+   {
+      memcpy(&word1, &buff1[pos], (size_t)8);
+      memcpy(&word2, &buff2[pos], (size_t)8);
+      if (word1 != word2)
+         break;
+   };
+   for(; ((pos < len) && (buff1[pos] == buff2[pos])); pos++);
+
+   return(pos);
+}
+
+
 /// closes a file
 /// @param[in]  file       file to use for operations
 /// @param[in]  verbose    verbose level of messages to display
@@ -399,6 +751,12 @@ int my_close(BinDumpFile * file, unsigned verbose)
    if (verbose > 0)
       printf("read %zu bytes from %s\n", file->read, file->filename);
 
+   if ((file->mapped))
+      munmap(file->buff, file->buff_len);
+   else
+      free(file->buff);
+   file->buff = NULL;
+
    if (file->fd == STDIN_FILENO)
       return(1);
 
@@ -409,285 +767,1197 @@ int my_close(BinDumpFile * file, unsigned verbose)
 }
 
 
-/// preforms lseek on file
+/// reads data into block buffer until at least the requested bytes are available
 /// @param[in]  file       file to use for operations
-/// @param[in]  offset     offset
+/// @param[in]  want       number of bytes requested
 /// @param[in]  verbose    verbose level of messages to display
-int my_lseek(BinDumpFile * file, size_t offset, unsigned verbose)
+int my_fill(BinDumpFile * file, size_t want, unsigned verbose)
 {
-   if ( (file->fd == -1) || (file->fd == STDIN_FILENO) )
+   size_t  size;
+   ssize_t code;
+
+   if ((file->mapped))
       return(0);
-   if ((lseek(file->fd, (off_t)offset, SEEK_SET) == -1))
+
+   // moves unprocessed data to the beginning of the block buffer
+   if (file->buff_pos)
    {
-      perror(PROGRAM_NAME ": lseek()");
-      my_close(file, verbose);
-      return(-1);
+      memmove(file->buff, &file->buff[file->buff_pos], file->buff_len - file->buff_pos);
+      file->buff_len -= file->buff_pos;
+      file->buff_pos  = 0;
    };
-   file->pos += offset;
+
+   while (file->buff_len < want)
+   {
+      size = file->buff_size - file->buff_len;
+      if ((file->limit))
+      {
+         if (file->received >= file->limit)
+            return(0);
+         size = ((file->limit - file->received) < size) ? file->limit - file->received : size;
+      };
+      if ((code = read(file->fd, &file->buff[file->buff_len], size)) == -1)
+      {
+         perror(PROGRAM_NAME ": read()");
+         my_close(file, verbose);
+         return(-1);
+      };
+      if (!(code))
+         return(0);
+      file->buff_len += (size_t)code;
+      file->received += (size_t)code;
+   };
+
    return(0);
 }
 
 
-/// determines the max number of bytes to dislpay
-/// @param[in]  pos        pos
-/// @param[in]  code       code
-/// @param[in]  len        len
-/// @param[in]  offset     offset
-size_t my_max(ssize_t code, size_t len)
+/// converts a hex digit to an integer
+/// @param[in]  c          hex digit
+/// @return Returns the value of the digit, or -1 if not a hex digit.
+int my_hex2int(int c)
 {
-   size_t max;
-   if (code < 1)
-      return(0);
-   len = len ? len : 8;
-   max = (len > (size_t)code) ? (size_t)code : len;
-   return(max);
+   if ( (c >= '0') && (c <= '9') )
+      return(c - '0');
+   if ( (c >= 'a') && (c <= 'f') )
+      return(c - 'a' + 10);
+   if ( (c >= 'A') && (c <= 'F') )
+      return(c - 'A' + 10);
+   return(-1);
 }
 
 
-/// opens a file
-/// @param[in]  file       file to use for operations
-/// @param[in]  verbose    verbose level of messages to display
-int my_open(BinDumpFile * file, unsigned verbose)
+/// formats the chunks of a file on behalf of the parallel dump
+/// @param[in]  arg        shared state of threads
+void * my_jobs_thread(void * arg)
 {
-   file->fd = -1;
+   int            rc;
+   size_t         chunk;
+   BinDumpJobs  * jobs;
+   BinDumpChunk * ptr;
 
-   if (!(file->filename))
-   {
-      file->eof = 1;
-      return(0);
-   };
-   if (!(strcmp(file->filename, "-")))
+   jobs = arg;
+
+   pthread_mutex_lock(&jobs->mutex);
+   for(;;)
    {
-      file->filename = "<stdin>";
-      file->fd = STDIN_FILENO;
-      return(0);
-   };
+      // waits for a free slot in the ring of chunks
+      while ( (!(jobs->stop)) && (jobs->chunk_next < jobs->chunk_total) &&
+              (jobs->chunk_next >= (jobs->chunk_emit + jobs->chunk_count)) )
+         pthread_cond_wait(&jobs->cond, &jobs->mutex);
+      if ( (jobs->stop) || (jobs->chunk_next >= jobs->chunk_total) )
+         break;
+      chunk = jobs->chunk_next++;
+      ptr   = &jobs->chunks[chunk % jobs->chunk_count];
+      pthread_mutex_unlock(&jobs->mutex);
 
-   if (verbose > 2)
-      printf("opening %s...\n", file->filename);
+      rc = my_print_chunk(jobs, &ptr->out, chunk);
 
-   if ((file->fd = open(file->filename, O_RDONLY)) == -1)
-   {
-      perror(PROGRAM_NAME ": open()");
-      return(1);
+      pthread_mutex_lock(&jobs->mutex);
+      ptr->done = (rc == -1) ? -1 : 1;
+      pthread_cond_broadcast(&jobs->cond);
    };
+   pthread_mutex_unlock(&jobs->mutex);
 
-   return(0);
+   return(NULL);
 }
 
 
-/// displays the diff between two files
-/// @param[in]  file1      first file to use for operations
-/// @param[in]  file2      second file to use for operations
+/// preforms lseek on file
+/// @param[in]  file       file to use for operations
 /// @param[in]  offset     offset
-/// @param[in]  len        len
 /// @param[in]  verbose    verbose level of messages to display
-/// @param[in]  opts       output options
-size_t my_print_diff(BinDumpFile * file1, BinDumpFile * file2, size_t offset,
-   size_t len, unsigned opts)
+int my_lseek(BinDumpFile * file, size_t offset, unsigned verbose)
 {
-   char    buff[9];
-   size_t  s;
-   size_t  max1;
-   size_t  max2;
-   size_t  line;
-   uint8_t diff;
-   uint8_t diff1[9];
-   uint8_t diff2[9];
+   size_t skip;
+   size_t skipped;
 
-   line = 0;
-   max1 = my_max(file1->code, len);
-   max2 = my_max(file2->code, len);
-
-   file1->pos += max1;
-   file2->pos += max2;
-
-   if ( (!(max1)) && (!(max2)) )
+   if (file->fd == -1)
       return(0);
-
-   diff = 0;
-   memset(diff1, 0, (size_t)9);
-   memset(diff2, 0, (size_t)9);
-   for(s = 0; s < (8-offset); s++)
+   if ((file->mapped))
    {
-      if ( (s < max1) && (s < max2) )
-      {
-         if (file1->data[s] != file2->data[s])
-         {
-            diff = 1;
-            diff1[s] = 1;
-            diff1[8] = 1;
-            diff2[s] = 1;
-            diff2[8] = 1;
-         };
-      } else if (s < max2) {
-         diff = 1;
-         diff2[s] = 1;
-         diff2[8] = 1;
-         if (max1)
-            diff1[8] = 1;
-      } else if (s < max1) {
-         diff = 1;
-         diff1[s] = 1;
-         diff1[8] = 1;
-         if (max2)
-            diff2[8] = 1;
-      };
+      file->buff_pos = (offset < file->buff_len) ? offset : file->buff_len;
+      file->pos     += offset;
+      return(0);
    };
 
-   if (!(diff))
+   // seeks relative to the current position since stdin may not be at the
+   // start of the data
+   if ((lseek(file->fd, (off_t)offset, SEEK_CUR) != -1))
+   {
+      file->pos += offset;
       return(0);
-
-   // prints line offset
-   if ((max1) && (diff1[8]))
+   };
+   if (errno != ESPIPE)
    {
-      printf("%s< 0%07zo0:%s", ((opts & MY_OPT_XTERM) ? MY_TERM_BOLD : ""),
-                               ((file1->pos-max1)/8),
-                               ((opts & MY_OPT_XTERM) ? MY_TERM_RESET : ""));
-
-      // print leading spaces for offset
-      for(s = 0; s < offset; s++)
-         printf("         ");
+      perror(PROGRAM_NAME ": lseek()");
+      my_close(file, verbose);
+      return(-1);
+   };
 
-      // print each byte
-      for(s = 0; s < max1; s++)
-      {
-         if (diff1[s])
-         {
-            printf(" %s%s%s", ((opts & MY_OPT_XTERM) ? MY_TERM_DIFF : ""),
-                              my_byte2str(file1->data[s], buff, opts),
-                              ((opts & MY_OPT_XTERM) ? MY_TERM_RESET : ""));
-         } else {
-            printf(" %s", (opts & MY_OPT_ALL) ? my_byte2str(file1->data[s], buff, opts) : "        ");
-         };
-      };
-      for(s = max1+offset; s < 8; s++)
-         printf("         ");
-
-      // prints summary
-      printf("  ");
-      for(s = 0; s < offset; s++)
-         printf(" ");
-      for(s = 0; s < max1; s++)
+   // discards data from pipes a block at a time
+   for(skipped = 0; skipped < offset; skipped += skip)
+   {
+      if (file->buff_pos >= file->buff_len)
       {
-         if ( (diff1[s]) && (opts & MY_OPT_XTERM) )
-            printf("%s", MY_TERM_DIFF);
-         if ( (file1->data[s] >= 0x21) && (file1->data[s] <= 0x7e) )
-            printf("%c", file1->data[s]);
-         else
-            printf(".");
-         if ( (diff1[s]) && (opts & MY_OPT_XTERM) )
-            printf("%s", MY_TERM_RESET);
+         file->buff_pos = 0;
+         file->buff_len = 0;
+         if ((my_fill(file, file->buff_size, verbose) == -1))
+            return(-1);
+         if (!(file->buff_len))
+            break;
       };
-
-      printf("\n");
-
-      line++;
+      skip            = file->buff_len - file->buff_pos;
+      skip            = ((offset - skipped) < skip) ? offset - skipped : skip;
+      file->buff_pos += skip;
    };
+   file->pos += offset;
 
-   if ((max2) && (diff2[8]))
-   {
-      printf("%s> 0%07zo0:%s", ((opts & MY_OPT_XTERM) ? MY_TERM_BOLD : ""),
-                               ((file2->pos-max2)/8),
-                               ((opts & MY_OPT_XTERM) ? MY_TERM_RESET : ""));
+   return(0);
+}
 
-      // print leading spaces for offset
-      for(s = 0; s < offset; s++)
-         printf("         ");
 
-      // print each byte
-      for(s = 0; s < max2; s++)
+/// converts the output of bindump back into binary data
+/// @param[in]  out        output buffer
+/// @param[in]  file       file containing the output of bindump
+/// @param[in]  opts       output options
+/// @param[in]  verbose    verbose level of messages to display
+int my_revert(BinDumpOutput * out, BinDumpFile * file, unsigned opts,
+   unsigned verbose)
+{
+   size_t       pos;
+   size_t       lineno;
+   size_t       len;
+   const char * line;
+   const char * eol;
+
+   pos    = 0;
+   lineno = 0;
+   for(;;)
+   {
+      // locates the end of the next line, reading more data as needed
+      line = &file->buff[file->buff_pos];
+      len  = file->buff_len - file->buff_pos;
+      if (!(eol = memchr(line, '\n', len)))
       {
-         if (diff2[s])
+         if ( (!(file->mapped)) && (len < file->buff_size) )
+         {
+            if ((my_fill(file, file->buff_size, verbose) == -1))
+               return(-1);
+            if ((file->buff_len - file->buff_pos) > len)
+               continue;
+         };
+         if (!(len))
+            break;
+         if (len == file->buff_size)
          {
-            printf(" %s%s%s", ((opts & MY_OPT_XTERM) ? MY_TERM_DIFF : ""),
-                              my_byte2str(file2->data[s], buff, opts),
-                              ((opts & MY_OPT_XTERM) ? MY_TERM_RESET : ""));
-         } else {
-            printf(" %s", (opts & MY_OPT_ALL) ? my_byte2str(file2->data[s], buff, opts) : "        ");
+            fprintf(stderr, "%s: line %zu is too long\n", PROGRAM_NAME, lineno+1);
+            return(-1);
          };
+         eol = &line[len];
       };
-      for(s = max2+offset; s < 8; s++)
-         printf("         ");
-
-      // prints summary
-      printf("  ");
-      for(s = 0; s < offset; s++)
-         printf(" ");
-      for(s = 0; s < max2; s++)
+      len             = (size_t)(eol - line);
+      file->buff_pos += len + (((len < (file->buff_len - file->buff_pos))) ? 1 : 0);
+      file->read     += len + 1;
+      lineno++;
+
+      if ((my_revert_line(out, line, len, &pos, opts) == -1))
       {
-         if ( (diff2[s]) && (opts & MY_OPT_XTERM) )
-            printf("%s", MY_TERM_DIFF);
-         if ( (file2->data[s] >= 0x21) && (file2->data[s] <= 0x7e) )
-            printf("%c", file2->data[s]);
-         else
-            printf(".");
-         if ( (diff2[s]) && (opts & MY_OPT_XTERM) )
-            printf("%s", MY_TERM_RESET);
+         fprintf(stderr, "%s: invalid data on line %zu\n", PROGRAM_NAME, lineno);
+         return(-1);
       };
-
-      printf("\n");
-
-      line++;
+      if (out->fd == -1)
+         return(-1);
    };
 
-   return(line);
+   return(0);
 }
 
 
-/// displays one line 8 byte chunk of data
-/// @param[in]  file       file to use for operations
-/// @param[in]  offset     offset
+/// converts one line of the output of bindump back into binary data
+/// @param[in]  out        output buffer
+/// @param[in]  line       line of output
+/// @param[in]  len        length of line
+/// @param[in]  posp       number of bytes written
+/// @param[in]  opts       output options
+int my_revert_line(BinDumpOutput * out, const char * line, size_t len,
+   size_t * posp, unsigned opts)
+{
+   int          c;
+   char       * ptr;
+   size_t       s;
+   size_t       b;
+   size_t       n;
+   size_t       pos;
+   size_t       start;
+   const char * field;
+   char         bits[8];
+   char         buff[MY_REVERT_LINE];
+
+   // removes terminal escape codes by copying the text between them
+   if ((field = memchr(line, 0x1b, len)))
+   {
+      for(s = 0, b = 0; ( (s < len) && (b < sizeof(buff)) ); )
+      {
+         if (!(field))
+            field = &line[len];
+         n = (size_t)(field - &line[s]);
+         n = ((sizeof(buff) - b) < n) ? sizeof(buff) - b : n;
+         memcpy(&buff[b], &line[s], n);
+         b += n;
+         s += n;
+         if (s >= len)
+            break;
+         if ( (line[s] == 0x1b) && ((s+1) < len) && (line[s+1] == '[') )
+            for(s += 2; ( (s < len) && ((line[s] < 0x40) || (line[s] > 0x7e)) ); s++);
+         s++;
+         field = (s < len) ? memchr(&line[s], 0x1b, len - s) : NULL;
+      };
+      line = buff;
+      len  = b;
+   };
+
+   // skips column headers, diffs, and other messages
+   if ( (len < 2) || (line[0] != '0') )
+      return(0);
+
+   // parses the offset of the line
+   for(s = 1, start = 0; ( (s < len) && (line[s] >= '0') && (line[s] <= '7') ); s++)
+      start = (start << 3) | (size_t)(line[s] - '0');
+   if ( (s >= len) || (line[s] != ':') )
+      return(0);
+   line = &line[s+1];
+   len -= s + 1;
+
+   // fills gaps between lines with zeros
+   pos = *posp;
+   if (start < pos)
+      return(-1);
+   while (pos < start)
+   {
+      b = ((start - pos) < MY_OUTPUT_SIZE) ? start - pos : MY_OUTPUT_SIZE;
+      if (!(ptr = my_out_reserve(out, b)))
+         return(-1);
+      memset(ptr, 0, b);
+      out->len += b;
+      pos      += b;
+   };
+   if (!(ptr = my_out_reserve(out, my_layout.width)))
+      return(-1);
+
+   // parses each column of binary notation
+   for(s = 0; s < my_layout.width; s++)
+   {
+      if ((my_layout.col[s] + my_layout.bits_len) > len)
+         break;
+      field = &line[my_layout.col[s]];
+      if (field[0] == ' ')
+         continue;
+      if (my_layout.bits_len == 8)
+         memcpy(bits, field, (size_t)8);
+      else
+         for(b = 0; b < 8; b++)
+            bits[b] = field[b + (b / my_layout.group)];
+      if ((c = my_str2byte(bits, opts)) == -1)
+         return(-1);
+
+      // leading blank columns of the first line are filled with zeros
+      for(; (pos < (start + s)); pos++)
+         *ptr++ = '\0';
+      *ptr++ = (char)c;
+      pos++;
+   };
+   out->len = (size_t)(ptr - out->buff);
+   *posp    = pos;
+
+   return(0);
+}
+
+
+/// displays each location of a bit pattern within a file
+/// @param[in]  out        output buffer
+/// @param[in]  file       file to use for operations
+/// @param[in]  pattern    bit pattern to locate
+/// @param[in]  len        len
+/// @param[in]  opts       output options
+/// @param[in]  verbose    verbose level of messages to display
+/// @return Returns 1 if the pattern was found, 0 if the pattern was not
+///         found, or -1 on error.
+int my_search(BinDumpOutput * out, BinDumpFile * file,
+   const BinDumpPattern * pattern, size_t len, unsigned opts,
+   unsigned verbose)
+{
+   unsigned                o;
+   unsigned                u;
+   unsigned                hit;
+   ssize_t                 rc;
+   size_t                  n;
+   size_t                  s;
+   size_t                  count;
+   size_t                  total;
+   size_t                  matches;
+   uint64_t                window;
+   const unsigned char   * data;
+   uint8_t                 map[256];
+
+   // the window holds bits in the order in which they are displayed
+   for(u = 0; u < 256; u++)
+   {
+      map[u] = (uint8_t)u;
+      if ((opts & MY_OPT_REVERSEBIT))
+         for(o = 0, map[u] = 0; o < 8; o++)
+            map[u] |= (uint8_t)(((u >> o) & 0x01) << (7 - o));
+   };
+
+   window  = 0;
+   count   = 0;
+   total   = 0;
+   matches = 0;
+
+   // shifts each byte into the window and compares the byte at the top
+   for(;;)
+   {
+      if (file->buff_pos >= file->buff_len)
+         if ((my_fill(file, file->buff_size, verbose) == -1))
+            return(-1);
+      n = file->buff_len - file->buff_pos;
+      if ((len))
+         n = ((len - file->read) < n) ? len - file->read : n;
+      if (!(n))
+         break;
+      data = (const unsigned char *)&file->buff[file->buff_pos];
+      for(s = 0; s < n; s++)
+      {
+         window = (window << 8) | map[data[s]];
+         if (++count < 8)
+            continue;
+
+         // compares all bit positions at once before reporting matches
+         hit = 0;
+         for(o = 0; o < 8; o++)
+            hit |= ((window & pattern->mask[o]) == pattern->value[o]) ? 1 : 0;
+         if (!(hit))
+            continue;
+         if ((rc = my_search_window(out, pattern, window, file->pos + count - 8, (size_t)64)) == -1)
+            return(-1);
+         matches += (size_t)rc;
+      };
+      file->buff_pos += n;
+      file->read     += n;
+      total          += n;
+      if (out->fd == -1)
+         return(-1);
+   };
+
+   // shifts the last bytes of data to the top of the window
+   while (count < (total + 7))
+   {
+      window <<= 8;
+      if (++count < 8)
+         continue;
+      if ((rc = my_search_window(out, pattern, window, file->pos + count - 8, (total + 8 - count) * 8)) == -1)
+         return(-1);
+      matches += (size_t)rc;
+   };
+   file->pos += total;
+
+   if (verbose > 0)
+   {
+      my_out_flush(out);
+      printf("found %zu matches\n", matches);
+   };
+
+   return((matches) ? 1 : 0);
+}
+
+
+/// compares a bit pattern with each bit of the first byte of a window
+/// @param[in]  out        output buffer
+/// @param[in]  pattern    bit pattern to locate
+/// @param[in]  window     next 64 bits of data
+/// @param[in]  pos        position of the first byte of the window
+/// @param[in]  avail      number of bits of data within the window
+ssize_t my_search_window(BinDumpOutput * out, const BinDumpPattern * pattern,
+   uint64_t window, size_t pos, size_t avail)
+{
+   char     * ptr;
+   unsigned   o;
+   ssize_t    matches;
+
+   matches = 0;
+   for(o = 0; o < 8; o++)
+   {
+      if ((window & pattern->mask[o]) != pattern->value[o])
+         continue;
+      if ((o + pattern->bits) > avail)
+         continue;
+      if (!(ptr = my_out_reserve(out, (size_t)32)))
+         return(-1);
+      out->len += (size_t)snprintf(ptr, 32, "0%08zo.%u\n", pos, o);
+      matches++;
+   };
+
+   return(matches);
+}
+
+
+/// advances both files past lines which are identical
+/// @param[in]  file1      first file to use for operations
+/// @param[in]  file2      second file to use for operations
 /// @param[in]  len        len
+/// @param[in]  context    number of identical lines to leave before a difference
 /// @param[in]  verbose    verbose level of messages to display
+/// @return Returns the number of identical lines left before the next
+///         difference, 0 if no difference was found, or -1 on error.
+ssize_t my_skip(BinDumpFile * file1, BinDumpFile * file2, size_t len,
+   size_t context, unsigned verbose)
+{
+   size_t avail;
+   size_t same;
+   size_t skip;
+   size_t keep;
+   size_t checked;
+   int    found;
+
+   if ( (file1->fd == -1) || (file2->fd == -1) || (file1->eof) || (file2->eof) )
+      return(0);
+
+   // context lines must fit within the block buffers
+   keep = (file1->buff_size < file2->buff_size) ? file1->buff_size : file2->buff_size;
+   keep = (keep / 2) - ((keep / 2) % my_layout.width);
+   keep = ((context * my_layout.width) < keep) ? context * my_layout.width : keep;
+
+   checked = 0;
+   for(;;)
+   {
+      avail = file1->buff_len - file1->buff_pos;
+      if ((file2->buff_len - file2->buff_pos) < avail)
+         avail = file2->buff_len - file2->buff_pos;
+      if (avail < (checked + my_layout.width))
+      {
+         if ((my_fill(file1, file1->buff_size, verbose) == -1))
+            return(-1);
+         if ((my_fill(file2, file2->buff_size, verbose) == -1))
+            return(-1);
+         avail = file1->buff_len - file1->buff_pos;
+         if ((file2->buff_len - file2->buff_pos) < avail)
+            avail = file2->buff_len - file2->buff_pos;
+      };
+      if ((len))
+         avail = ((len - file1->read) < avail) ? len - file1->read : avail;
+      if (avail < (checked + my_layout.width))
+         return(0);
+
+      // compares only whole lines
+      avail    = (avail - checked) - ((avail - checked) % my_layout.width);
+      same     = my_cmp(&file1->buff[file1->buff_pos + checked],
+                        &file2->buff[file2->buff_pos + checked], avail);
+      found    = (same < avail) ? 1 : 0;
+      checked += same - (same % my_layout.width);
+
+      // consumes identical lines except those kept for context
+      if (checked > keep)
+      {
+         skip             = checked - keep;
+         file1->buff_pos += skip;
+         file1->pos      += skip;
+         file1->read     += skip;
+         file2->buff_pos += skip;
+         file2->pos      += skip;
+         file2->read     += skip;
+         checked          = keep;
+      };
+
+      if ((found))
+         return((ssize_t)(checked / my_layout.width));
+   };
+}
+
+
+/// determines the max number of bytes to dislpay
+/// @param[in]  pos        pos
+/// @param[in]  code       code
+/// @param[in]  len        len
+/// @param[in]  offset     offset
+size_t my_max(ssize_t code, size_t len)
+{
+   size_t max;
+   if (code < 1)
+      return(0);
+   len = len ? len : my_layout.width;
+   max = (len > (size_t)code) ? (size_t)code : len;
+   return(max);
+}
+
+
+/// opens a file
+/// @param[in]  file       file to use for operations
+/// @param[in]  block      size of block buffer
+/// @param[in]  verbose    verbose level of messages to display
+int my_open(BinDumpFile * file, size_t block, unsigned verbose)
+{
+   struct stat sb;
+   void      * ptr;
+
+   file->fd = -1;
+
+   if (!(file->filename))
+   {
+      file->eof = 1;
+      return(0);
+   };
+   if (!(strcmp(file->filename, "-")))
+   {
+      file->filename = "<stdin>";
+      file->fd = STDIN_FILENO;
+   } else {
+      if (verbose > 2)
+         printf("opening %s...\n", file->filename);
+      if ((file->fd = open(file->filename, O_RDONLY)) == -1)
+      {
+         perror(PROGRAM_NAME ": open()");
+         return(1);
+      };
+   };
+
+   // maps regular files into memory instead of reading them
+   if ( (file->fd != STDIN_FILENO) && (fstat(file->fd, &sb) == 0) &&
+        (S_ISREG(sb.st_mode)) && (sb.st_size > 0) )
+   {
+      if ((ptr = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, file->fd, 0)) != MAP_FAILED)
+      {
+         if (verbose > 2)
+            printf("mapped %zu bytes of %s...\n", (size_t)sb.st_size, file->filename);
+         madvise(ptr, (size_t)sb.st_size, MADV_SEQUENTIAL);
+         file->buff      = ptr;
+         file->buff_len  = (size_t)sb.st_size;
+         file->buff_size = (size_t)sb.st_size;
+         file->mapped    = 1;
+         return(0);
+      };
+   };
+
+   if (!(file->buff = malloc(block)))
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      my_close(file, verbose);
+      return(-1);
+   };
+   file->buff_size = block;
+
+   return(0);
+}
+
+
+/// writes buffered output
+/// @param[in]  out        output buffer
+int my_out_flush(BinDumpOutput * out)
+{
+   size_t  pos;
+   ssize_t code;
+
+   if ( (out->fd == -1) || (!(out->len)) )
+      return(0);
+
+   // keeps output ordered with messages printed through stdio
+   fflush(stdout);
+
+   for(pos = 0; pos < out->len; pos += (size_t)code)
+   {
+      if ((code = write(out->fd, &out->buff[pos], out->len - pos)) == -1)
+      {
+         perror(PROGRAM_NAME ": write()");
+         out->fd = -1;
+         return(-1);
+      };
+   };
+   out->len = 0;
+
+   return(0);
+}
+
+
+/// reserves space in output buffer
+/// @param[in]  out        output buffer
+/// @param[in]  len        number of bytes to reserve
+char * my_out_reserve(BinDumpOutput * out, size_t len)
+{
+   void * ptr;
+
+   if ((out->len + len) <= out->size)
+      return(&out->buff[out->len]);
+
+   // output buffers which are not flushed grow to hold all of the output
+   if (out->fd != -1)
+   {
+      my_out_flush(out);
+      if (len <= out->size)
+         return(&out->buff[out->len]);
+   };
+   if (!(ptr = realloc(out->buff, out->len + len + out->size)))
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      return(NULL);
+   };
+   out->buff  = ptr;
+   out->size += out->len + len;
+
+   return(&out->buff[out->len]);
+}
+
+
+/// appends string to output buffer
+/// @param[in]  out        output buffer
+/// @param[in]  str        string to append
+/// @param[in]  len        length of string
+int my_out_str(BinDumpOutput * out, const char * str, size_t len)
+{
+   char * ptr;
+   if (!(ptr = my_out_reserve(out, len)))
+      return(-1);
+   memcpy(ptr, str, len);
+   out->len += len;
+   return(0);
+}
+
+
+/// displays the diff between two files
+/// @param[in]  out        output buffer
+/// @param[in]  file1      first file to use for operations
+/// @param[in]  file2      second file to use for operations
+/// @param[in]  offset     offset
+/// @param[in]  len        len
 /// @param[in]  opts       output options
-size_t my_print_dump(BinDumpFile * file, size_t offset, size_t len,
+size_t my_print_diff(BinDumpOutput * out, BinDumpFile * file1,
+   BinDumpFile * file2, size_t offset, size_t len, unsigned opts)
+{
+   char  * ptr;
+   size_t  s;
+   size_t  max1;
+   size_t  max2;
+   size_t  line;
+   size_t  width;
+   uint8_t diff;
+   uint8_t diff1[MY_WIDTH_MAX+1];
+   uint8_t diff2[MY_WIDTH_MAX+1];
+
+   line  = 0;
+   width = my_layout.width;
+   max1  = my_max(file1->code, len);
+   max2 = my_max(file2->code, len);
+
+   file1->pos += max1;
+   file2->pos += max2;
+
+   if ( (!(max1)) && (!(max2)) )
+      return(0);
+
+   diff = 0;
+   memset(diff1, 0, width+1);
+   memset(diff2, 0, width+1);
+   for(s = 0; s < (width-offset); s++)
+   {
+      if ( (s < max1) && (s < max2) )
+      {
+         if (file1->data[s] != file2->data[s])
+         {
+            diff = 1;
+            diff1[s] = 1;
+            diff1[width] = 1;
+            diff2[s] = 1;
+            diff2[width] = 1;
+         };
+      } else if (s < max2) {
+         diff = 1;
+         diff2[s] = 1;
+         diff2[width] = 1;
+         if (max1)
+            diff1[width] = 1;
+      } else if (s < max1) {
+         diff = 1;
+         diff1[s] = 1;
+         diff1[width] = 1;
+         if (max2)
+            diff2[width] = 1;
+      };
+   };
+
+   if (!(diff))
+      return(0);
+
+   if (!(ptr = my_out_reserve(out, my_layout.line_max * 2)))
+      return(0);
+
+   if ((max1) && (diff1[width]))
+   {
+      ptr = my_print_diff_line(ptr, '<', file1, max1, offset, diff1, opts);
+      line++;
+   };
+
+   if ((max2) && (diff2[width]))
+   {
+      ptr = my_print_diff_line(ptr, '>', file2, max2, offset, diff2, opts);
+      line++;
+   };
+
+   out->len = (size_t)(ptr - out->buff);
+
+   return(line);
+}
+
+
+/// displays a line which is identical in both files
+/// @param[in]  out        output buffer
+/// @param[in]  file       file to use for operations
+/// @param[in]  len        len
+/// @param[in]  opts       output options
+size_t my_print_context(BinDumpOutput * out, BinDumpFile * file, size_t len,
    unsigned opts)
 {
-   char   buff[9];
-   size_t s;
-   size_t max;
+   char    * ptr;
+   size_t    max;
+   uint8_t   diff[MY_WIDTH_MAX+1];
+
+   if (!(max = my_max(file->code, len)))
+      return(0);
+
+   if (!(ptr = my_out_reserve(out, my_layout.line_max)))
+      return(0);
+
+   memset(diff, 0, sizeof(diff));
+   ptr      = my_print_diff_line(ptr, ' ', file, max, 0, diff, (opts | MY_OPT_ALL));
+   out->len = (size_t)(ptr - out->buff);
+
+   return(1);
+}
+
+
+/// displays one side of a diff
+/// @param[in]  ptr        output buffer with room for a line
+/// @param[in]  prefix     character identifying the file
+/// @param[in]  file       file to use for operations
+/// @param[in]  max        number of bytes to display
+/// @param[in]  offset     offset
+/// @param[in]  diff       flags identifying the bytes which differ
+/// @param[in]  opts       output options
+char * my_print_diff_line(char * ptr, char prefix, BinDumpFile * file,
+   size_t max, size_t offset, const uint8_t * diff, unsigned opts)
+{
+   size_t           s;
+   size_t           bits_len;
+   char          (* bits)[MY_BITS_MAX];
+   unsigned char    c;
+
+   bits     = my_bits[(opts & MY_OPT_REVERSEBIT) ? 1 : 0];
+   bits_len = my_layout.bits_len;
+
+   // prints line offset
+   ptr = my_print_offset(ptr, prefix, (file->pos-max), opts);
+
+   // print leading spaces for offset
+   memcpy(ptr, my_layout.blank, my_layout.field[offset]);
+   ptr += my_layout.field[offset];
+
+   // print each byte
+   for(s = 0; s < max; s++)
+   {
+      c = (unsigned char)file->data[s];
+      if (my_layout.col[offset+s] != my_layout.field[offset+s])
+         *ptr++ = ' ';
+      if ( (diff[s]) && (opts & MY_OPT_XTERM) )
+      {
+         memcpy(ptr, MY_TERM_DIFF, sizeof(MY_TERM_DIFF)-1);
+         ptr += sizeof(MY_TERM_DIFF)-1;
+         memcpy(ptr, bits[c], bits_len);
+         ptr += bits_len;
+         memcpy(ptr, MY_TERM_RESET, sizeof(MY_TERM_RESET)-1);
+         ptr += sizeof(MY_TERM_RESET)-1;
+      } else if ( (diff[s]) || (opts & MY_OPT_ALL) ) {
+         memcpy(ptr, bits[c], bits_len);
+         ptr += bits_len;
+      } else {
+         memset(ptr, ' ', bits_len);
+         ptr += bits_len;
+      };
+   };
+   memcpy(ptr, my_layout.blank, my_layout.area_len - my_layout.field[max+offset]);
+   ptr += my_layout.area_len - my_layout.field[max+offset];
+
+   // prints summary
+   memset(ptr, ' ', offset + 2);
+   ptr += offset + 2;
+   for(s = 0; s < max; s++)
+   {
+      c = (unsigned char)file->data[s];
+      if ( (diff[s]) && (opts & MY_OPT_XTERM) )
+      {
+         memcpy(ptr, MY_TERM_DIFF, sizeof(MY_TERM_DIFF)-1);
+         ptr += sizeof(MY_TERM_DIFF)-1;
+      };
+      *ptr++ = ( (c >= 0x21) && (c <= 0x7e) ) ? (char)c : '.';
+      if ( (diff[s]) && (opts & MY_OPT_XTERM) )
+      {
+         memcpy(ptr, MY_TERM_RESET, sizeof(MY_TERM_RESET)-1);
+         ptr += sizeof(MY_TERM_RESET)-1;
+      };
+   };
+
+   *ptr++ = '\n';
+
+   return(ptr);
+}
+
+
+/// displays one chunk of a file
+/// @param[in]  jobs       shared state of threads
+/// @param[in]  out        output buffer of chunk
+/// @param[in]  chunk      index of chunk to display
+int my_print_chunk(BinDumpJobs * jobs, BinDumpOutput * out, size_t chunk)
+{
+   size_t      start;
+   size_t      end;
+   size_t      line;
+   BinDumpFile file;
+
+   start = chunk * jobs->chunk_size;
+   end   = start + jobs->chunk_size;
+   end   = (end < jobs->len) ? end : jobs->len;
+
+   // limits a private copy of the file state to the chunk
+   memcpy(&file, jobs->file, sizeof(BinDumpFile));
+   file.buff_len  = file.buff_pos + end;
+   file.buff_pos += start;
+   file.pos      += start;
+   file.read      = 0;
+
+   // offset labels and headers are derived from the position of the chunk
+   line = jobs->line + (start / my_layout.width);
+   while ((my_read(&file, (size_t)0, (size_t)0, 0) > 0))
+   {
+      if (!(my_print_dump(out, &file, (size_t)0, (size_t)0, jobs->opts)))
+         return(-1);
+      line++;
+      if (!(line % 22))
+         my_print_header(out, 0, jobs->opts);
+   };
+
+   return(0);
+}
+
+
+/// displays one line of data
+/// @param[in]  out        output buffer
+/// @param[in]  file       file to use for operations
+/// @param[in]  offset     offset
+/// @param[in]  len        len
+/// @param[in]  opts       output options
+size_t my_print_dump(BinDumpOutput * out, BinDumpFile * file, size_t offset,
+   size_t len, unsigned opts)
+{
+   char            * ptr;
+   size_t            s;
+   size_t            max;
+   size_t            bits_len;
+   char           (* bits)[MY_BITS_MAX];
+   unsigned char     c;
 
    max = my_max(file->code, len);
 
    if (!(max))
       return(0);
 
-   // prints line offset
-   printf("%s0%07zo0:%s", ((opts & MY_OPT_XTERM) ? MY_TERM_BOLD : ""),
-                          (file->pos/8),
-                          ((opts & MY_OPT_XTERM) ? MY_TERM_RESET : ""));
+   if (!(ptr = my_out_reserve(out, my_layout.line_max)))
+      return(0);
+
+   bits     = my_bits[(opts & MY_OPT_REVERSEBIT) ? 1 : 0];
+   bits_len = my_layout.bits_len;
 
-   // prints spaces
-   for(s = 0; s < offset; s++)
-      printf("         ");
+   // prints line offset
+   ptr = my_print_offset(ptr, '\0', file->pos, opts);
 
-   // prints each byte
+   // fills in the template of the line with each byte
+   memcpy(ptr, my_layout.blank, my_layout.area_len);
    for(s = 0; s < max; s++)
-         printf(" %s", my_byte2str(file->data[s], buff, opts));
-   for(s = max+offset; s < 8; s++)
-      printf("         ");
+      memcpy(&ptr[my_layout.col[offset+s]], bits[(unsigned char)file->data[s]], bits_len);
+   ptr += my_layout.area_len;
 
    // prints summary
-   printf("  ");
-   for(s = 0; s < offset; s++)
-      printf(" ");
+   memset(ptr, ' ', offset + 2);
+   ptr += offset + 2;
    for(s = 0; s < max; s++)
    {
-      if ( (file->data[s] >= 0x21) && (file->data[s] <= 0x7e) )
-         printf("%c", file->data[s]);
-      else
-         printf(".");
+      c      = (unsigned char)file->data[s];
+      *ptr++ = ( (c >= 0x21) && (c <= 0x7e) ) ? (char)c : '.';
    };
 
-   printf("\n");
+   *ptr++ = '\n';
 
+   out->len   = (size_t)(ptr - out->buff);
    file->pos += max;
 
    return(1);
 }
 
 
+/// displays column headers
+/// @param[in]  out        output buffer
+/// @param[in]  diff       headers are for a diff of two files
+/// @param[in]  opts       output options
+int my_print_header(BinDumpOutput * out, int diff, unsigned opts)
+{
+   if ((diff))
+      if ((my_out_str(out, "  ", (size_t)2)))
+         return(-1);
+   if ((opts & MY_OPT_XTERM))
+      if ((my_out_str(out, MY_TERM_BOLD, sizeof(MY_TERM_BOLD)-1)))
+         return(-1);
+   if ((my_out_str(out, my_layout.header, my_layout.header_len)))
+      return(-1);
+   if ((opts & MY_OPT_XTERM))
+      if ((my_out_str(out, MY_TERM_RESET, sizeof(MY_TERM_RESET)-1)))
+         return(-1);
+   return(my_out_str(out, "\n", (size_t)1));
+}
+
+
+/// parses a bit pattern
+/// @param[in]  pattern    buffer to hold the parsed pattern
+/// @param[in]  str        bit string or hex string with an optional mask
+int my_pattern(BinDumpPattern * pattern, const char * str)
+{
+   unsigned      o;
+   int           c;
+   const char  * ptr;
+   const char  * mask;
+   uint64_t      value;
+   uint64_t      bits;
+
+   memset(pattern, 0, sizeof(BinDumpPattern));
+   value = 0;
+   bits  = 0;
+
+   // hex strings are specified as 0x<hex>[/<hex mask>]
+   if ( (str[0] == '0') && ((str[1] == 'x') || (str[1] == 'X')) )
+   {
+      mask = NULL;
+      for(ptr = &str[2]; ( (*ptr) && (*ptr != '/') ); ptr++)
+      {
+         if ((c = my_hex2int(*ptr)) == -1)
+            break;
+         value = (value << 4) | (uint64_t)c;
+         bits  = (bits  << 4) | 0x0f;
+         pattern->bits += 4;
+         if (pattern->bits > MY_PATTERN_MAX)
+            break;
+      };
+      if (*ptr == '/')
+      {
+         mask  = &ptr[1];
+         bits  = 0;
+         if ( (mask[0] == '0') && ((mask[1] == 'x') || (mask[1] == 'X')) )
+            mask = &mask[2];
+         for(ptr = mask; ( (*ptr) && (my_hex2int(*ptr) != -1) ); ptr++)
+            bits = (bits << 4) | (uint64_t)my_hex2int(*ptr);
+         if ((size_t)(ptr - mask) != (pattern->bits / 4))
+         {
+            fprintf(stderr, "%s: pattern mask must be the same length as the pattern\n", PROGRAM_NAME);
+            return(-1);
+         };
+      };
+   }
+
+   // bit strings are specified as 0, 1, or . for bits which are ignored
+   else
+   {
+      for(ptr = str; ( (*ptr) && (pattern->bits <= MY_PATTERN_MAX) ); ptr++)
+      {
+         if ( (*ptr != '0') && (*ptr != '1') && (*ptr != '.') )
+            break;
+         value = (value << 1) | ((*ptr == '1') ? 1 : 0);
+         bits  = (bits  << 1) | ((*ptr == '.') ? 0 : 1);
+         pattern->bits++;
+      };
+   };
+
+   if ( (*ptr) || (!(pattern->bits)) || (pattern->bits > MY_PATTERN_MAX) )
+   {
+      fprintf(stderr, "%s: invalid bit pattern `%s' (max %i bits)\n", PROGRAM_NAME, str, MY_PATTERN_MAX);
+      return(-1);
+   };
+
+   // aligns pattern with the most significant bits of a 64 bit window for
+   // each of the bit positions within the first byte of a match
+   value <<= 64 - pattern->bits;
+   bits  <<= 64 - pattern->bits;
+   for(o = 0; o < 8; o++)
+   {
+      pattern->mask[o]  = bits  >> o;
+      pattern->value[o] = (value & bits) >> o;
+   };
+
+   return(0);
+}
+
+
+/// displays a file using multiple threads
+/// @param[in]  out        output buffer
+/// @param[in]  file       file to use for operations
+/// @param[in]  len        len
+/// @param[in]  linep      number of lines displayed
+/// @param[in]  jobs       number of threads
+/// @param[in]  opts       output options
+/// @param[in]  verbose    verbose level of messages to display
+int my_print_parallel(BinDumpOutput * out, BinDumpFile * file, size_t len,
+   size_t * linep, unsigned jobs, unsigned opts, unsigned verbose)
+{
+   int            rc;
+   int            done;
+   unsigned       count;
+   size_t         chunk;
+   BinDumpJobs    state;
+   BinDumpChunk * ptr;
+   pthread_t      threads[MY_JOBS_MAX];
+
+   memset(&state, 0, sizeof(BinDumpJobs));
+   state.file = file;
+   state.len  = file->buff_len - file->buff_pos;
+   if ((len))
+      state.len = ((len - file->read) < state.len) ? len - file->read : state.len;
+   state.line        = *linep;
+   state.opts        = opts;
+   state.chunk_size  = MY_CHUNK_SIZE - (MY_CHUNK_SIZE % my_layout.width);
+   state.chunk_total = (state.len + state.chunk_size - 1) / state.chunk_size;
+   state.chunk_count = jobs * 2;
+
+   // small files are not worth the overhead of threads
+   if (state.chunk_total < 2)
+      return(0);
+   if (verbose > 2)
+      printf("formatting %zu chunks using %u threads...\n", state.chunk_total, jobs);
+
+   if (!(state.chunks = calloc(state.chunk_count, sizeof(BinDumpChunk))))
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      return(-1);
+   };
+   for(chunk = 0; chunk < state.chunk_count; chunk++)
+      state.chunks[chunk].out.fd = -1;
+   pthread_mutex_init(&state.mutex, NULL);
+   pthread_cond_init(&state.cond, NULL);
+
+   for(count = 0; count < jobs; count++)
+   {
+      if ((rc = pthread_create(&threads[count], NULL, my_jobs_thread, &state)))
+      {
+         fprintf(stderr, "%s: pthread_create(): %s\n", PROGRAM_NAME, strerror(rc));
+         break;
+      };
+   };
+
+   // writes the chunks in order as they are formatted
+   rc = (count) ? 0 : -1;
+   for(chunk = 0; ((chunk < state.chunk_total) && (rc == 0)); chunk++)
+   {
+      ptr = &state.chunks[chunk % state.chunk_count];
+      pthread_mutex_lock(&state.mutex);
+      while (!(done = ptr->done))
+         pthread_cond_wait(&state.cond, &state.mutex);
+      pthread_mutex_unlock(&state.mutex);
+
+      if (done == -1)
+         rc = -1;
+      else if ((my_out_flush(out) == -1))
+         rc = -1;
+      else
+      {
+         ptr->out.fd = out->fd;
+         if ((my_out_flush(&ptr->out) == -1))
+            rc = out->fd = -1;
+         ptr->out.fd  = -1;
+         ptr->out.len = 0;
+      };
+
+      pthread_mutex_lock(&state.mutex);
+      ptr->done = 0;
+      state.chunk_emit++;
+      pthread_cond_broadcast(&state.cond);
+      pthread_mutex_unlock(&state.mutex);
+   };
+
+   // stops threads
+   pthread_mutex_lock(&state.mutex);
+   state.stop = 1;
+   pthread_cond_broadcast(&state.cond);
+   pthread_mutex_unlock(&state.mutex);
+   while (count > 0)
+      pthread_join(threads[--count], NULL);
+
+   for(chunk = 0; chunk < state.chunk_count; chunk++)
+      free(state.chunks[chunk].out.buff);
+   free(state.chunks);
+   pthread_mutex_destroy(&state.mutex);
+   pthread_cond_destroy(&state.cond);
+
+   if (rc == -1)
+      return(-1);
+
+   // advances file past the formatted data
+   file->buff_pos += state.len;
+   file->pos      += state.len;
+   file->read     += state.len;
+   *linep         += (state.len + my_layout.width - 1) / my_layout.width;
+
+   return(0);
+}
+
+
+/// formats line offset
+/// @param[in]  ptr        output buffer
+/// @param[in]  prefix     character identifying the file of a diff, or NUL
+/// @param[in]  pos        position within file
+/// @param[in]  opts       output options
+char * my_print_offset(char * ptr, char prefix, size_t pos, unsigned opts)
+{
+   char   digits[24];
+   size_t len;
+   size_t line;
+
+   if ((opts & MY_OPT_XTERM))
+   {
+      memcpy(ptr, MY_TERM_BOLD, sizeof(MY_TERM_BOLD)-1);
+      ptr += sizeof(MY_TERM_BOLD)-1;
+   };
+   if ((prefix))
+   {
+      *ptr++ = prefix;
+      *ptr++ = ' ';
+   };
+
+   // same as printf("0%08zo:", pos) using the start of the line
+   line = pos - (pos % my_layout.width);
+   len  = 0;
+   do
+   {
+      digits[len++] = (char)('0' + (line & 0x07));
+      line >>= 3;
+   } while ((line));
+   while (len < 8)
+      digits[len++] = '0';
+   *ptr++ = '0';
+   while (len > 0)
+      *ptr++ = digits[--len];
+   *ptr++ = ':';
+
+   if ((opts & MY_OPT_XTERM))
+   {
+      memcpy(ptr, MY_TERM_RESET, sizeof(MY_TERM_RESET)-1);
+      ptr += sizeof(MY_TERM_RESET)-1;
+   };
+
+   return(ptr);
+}
+
+
 /// performs read upon file
 /// @param[in]  file       file to use for operations
 /// @param[in]  offset     offset
@@ -701,16 +1971,17 @@ ssize_t my_read(BinDumpFile * file, size_t offset, size_t len, unsigned verbose)
 
    file->code = 0;
 
-   max = 8 - offset;
+   max = my_layout.width - offset;
    if (len)
       max = ((len - file->read) < max) ? len - file->read : max;
 
-   if ((file->code = read(file->fd, file->data, max)) == -1)
-   {
-      perror(PROGRAM_NAME ": read()");
-      my_close(file, verbose);
-      return(-1);
-   };
+   if ((file->buff_len - file->buff_pos) < max)
+      if ((my_fill(file, max, verbose) == -1))
+         return(-1);
+
+   file->code      = (ssize_t)(((file->buff_len - file->buff_pos) < max) ? file->buff_len - file->buff_pos : max);
+   file->data      = &file->buff[file->buff_pos];
+   file->buff_pos += (size_t)file->code;
 
    if (file->code < 1)
       file->eof = 1;
@@ -729,13 +2000,20 @@ ssize_t my_read(BinDumpFile * file, size_t offset, size_t len, unsigned verbose)
 void my_usage()
 {
    printf("Usage: %s [options] file\n", PROGRAM_NAME);
+   printf("  -b bytes                  size of read buffer\n");
+   printf("  -C lines                  number of identical lines to display around differences\n");
    printf("  -d                        print only differing data\n");
+   printf("  -g bits                   number of bits displayed per group\n");
    printf("  -h, --help                print this help and exit\n");
+   printf("  -j jobs                   number of threads used to format a file\n");
    printf("  -l bytes                  length of data to display\n");
    printf("  -o bytes                  offset to start reading data\n");
    printf("  -r                        display in reverse bit order\n");
+   printf("  -R                        convert a dump back into binary data\n");
+   printf("  -s pattern                search for bits (0, 1, .) or hex (0x<hex>[/<mask>])\n");
    printf("  -V, --version             print verbose messages\n");
    printf("  -v, --verbose             print version number and exit\n");
+   printf("  -w bytes                  number of bytes displayed per line\n");
    printf("  -x                        disables Xterm output\n");
    printf("\n");
    printf("Report bugs to <%s>.\n", PACKAGE_BUGREPORT);
@@ -777,4 +2055,124 @@ char * my_byte2str(signed data, char * buff, unsigned opts)
    return(buff);
 }
 
+
+/// converts binary notation of a byte into the value of the byte
+/// @param[in]  str        eight characters of '0' or '1'
+/// @param[in]  opts       output options
+/// @return Returns the value of the byte, or -1 if the string is invalid.
+int my_str2byte(const char * str, unsigned opts)
+{
+   uint64_t                word;
+   const unsigned char   * ptr;
+
+   // loads the characters so the first character is the lowest byte
+   ptr  = (const unsigned char *)str;
+   word = ((uint64_t)ptr[0]      ) | ((uint64_t)ptr[1] <<  8) |
+          ((uint64_t)ptr[2] << 16) | ((uint64_t)ptr[3] << 24) |
+          ((uint64_t)ptr[4] << 32) | ((uint64_t)ptr[5] << 40) |
+          ((uint64_t)ptr[6] << 48) | ((uint64_t)ptr[7] << 56);
+
+   // verifies every character is '0' (0x30) or '1' (0x31)
+   if ((word & 0xfefefefefefefefeULL) != 0x3030303030303030ULL)
+      return(-1);
+   word &= 0x0101010101010101ULL;
+
+   // gathers the low bit of each character into the top byte of the
+   // product, each bit of the product is produced by a single term
+   if ((opts & MY_OPT_REVERSEBIT))
+      return((int)((word * 0x0102040810204080ULL) >> 56));
+   return((int)((word * 0x8040201008040201ULL) >> 56));
+}
+
+
+/// builds tables of binary notation and the layout of a line
+/// @param[in]  width      number of bytes displayed per line
+/// @param[in]  group      number of bits displayed per group
+int my_init_layout(size_t width, size_t group)
+{
+   unsigned          u;
+   size_t            s;
+   size_t            b;
+   size_t            pos;
+   size_t            step;
+   char              buff[9];
+
+   if ( (width < 1) || (width > MY_WIDTH_MAX) )
+   {
+      fprintf(stderr, "%s: bytes per line must be between 1 and %i\n", PROGRAM_NAME, MY_WIDTH_MAX);
+      return(-1);
+   };
+   if ( (group < 1) || ((group & (group - 1))) || (group > (width * 8)) )
+   {
+      fprintf(stderr, "%s: bits per group must be a power of 2 no larger than a line\n", PROGRAM_NAME);
+      return(-1);
+   };
+   if ( (group > 8) && ((width % (group / 8))) )
+   {
+      fprintf(stderr, "%s: bytes per line must be a multiple of the bytes per group\n", PROGRAM_NAME);
+      return(-1);
+   };
+
+   memset(&my_layout, 0, sizeof(BinDumpLayout));
+   my_layout.width    = width;
+   my_layout.group    = group;
+   my_layout.bits_len = (group < 8) ? (8 + (8 / group) - 1) : 8;
+
+   // builds binary notation of each byte with groups separated by spaces
+   step = (group < 8) ? group : 8;
+   for(u = 0; u < 256; u++)
+   {
+      my_byte2str((signed)u, buff, 0);
+      for(b = 0, pos = 0; b < 8; b++)
+      {
+         if ( (b) && (!(b % step)) )
+            my_bits[0][u][pos++] = ' ';
+         my_bits[0][u][pos++] = buff[b];
+      };
+      my_byte2str((signed)u, buff, MY_OPT_REVERSEBIT);
+      for(b = 0, pos = 0; b < 8; b++)
+      {
+         if ( (b) && (!(b % step)) )
+            my_bits[1][u][pos++] = ' ';
+         my_bits[1][u][pos++] = buff[b];
+      };
+   };
+
+   // determines the columns of each byte, groups larger than a byte are
+   // displayed without spaces between the bytes of the group
+   step = (group > 8) ? (group / 8) : 1;
+   for(s = 0, pos = 0; s < width; s++)
+   {
+      my_layout.field[s] = pos;
+      if (!(s % step))
+         pos++;
+      my_layout.col[s] = pos;
+      pos += my_layout.bits_len;
+   };
+   my_layout.field[width] = pos;
+   my_layout.area_len     = pos;
+   memset(my_layout.blank, ' ', pos);
+
+   // builds column headers in octal to match the line offsets, two digits
+   // are sufficient for MY_WIDTH_MAX bytes per line
+   memset(my_layout.header, ' ', sizeof(my_layout.header));
+   memcpy(my_layout.header, "offset", (size_t)6);
+   for(s = 0; s < width; s++)
+   {
+      pos = 10 + my_layout.col[s] + ((my_layout.bits_len - 2) / 2);
+      my_layout.header[pos+0] = (char)('0' + ((s >> 3) & 0x07));
+      my_layout.header[pos+1] = (char)('0' + (s & 0x07));
+   };
+   pos = 10 + my_layout.area_len + 2;
+   for(s = 0; s < width; s++)
+      my_layout.header[pos++] = (char)('0' + (s & 0x07));
+   my_layout.header_len = pos;
+
+   // offset, binary notation, summary, and escape codes of a diff
+   my_layout.line_max  = 64 + my_layout.area_len + 2 + width + 1;
+   my_layout.line_max += width * 2 * (sizeof(MY_TERM_DIFF) + sizeof(MY_TERM_RESET));
+
+   return(0);
+}
+
 // end of source file
@@ -67,6 +67,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <time.h>
 
 
 ///////////////////
@@ -95,6 +96,39 @@
 #define PARAMS(protos) protos
 #endif
 
+#define MY_BATCH_LINE   256
+#define MY_BENCH_BITS   4096
+#define MY_BENCH_ROUNDS 16
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+
+/// masks of the n least significant bits of a word
+static const uint64_t bitops_mask[65] =
+{
+   0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000000003ULL, 0x0000000000000007ULL,
+   0x000000000000000fULL, 0x000000000000001fULL, 0x000000000000003fULL, 0x000000000000007fULL,
+   0x00000000000000ffULL, 0x00000000000001ffULL, 0x00000000000003ffULL, 0x00000000000007ffULL,
+   0x0000000000000fffULL, 0x0000000000001fffULL, 0x0000000000003fffULL, 0x0000000000007fffULL,
+   0x000000000000ffffULL, 0x000000000001ffffULL, 0x000000000003ffffULL, 0x000000000007ffffULL,
+   0x00000000000fffffULL, 0x00000000001fffffULL, 0x00000000003fffffULL, 0x00000000007fffffULL,
+   0x0000000000ffffffULL, 0x0000000001ffffffULL, 0x0000000003ffffffULL, 0x0000000007ffffffULL,
+   0x000000000fffffffULL, 0x000000001fffffffULL, 0x000000003fffffffULL, 0x000000007fffffffULL,
+   0x00000000ffffffffULL, 0x00000001ffffffffULL, 0x00000003ffffffffULL, 0x00000007ffffffffULL,
+   0x0000000fffffffffULL, 0x0000001fffffffffULL, 0x0000003fffffffffULL, 0x0000007fffffffffULL,
+   0x000000ffffffffffULL, 0x000001ffffffffffULL, 0x000003ffffffffffULL, 0x000007ffffffffffULL,
+   0x00000fffffffffffULL, 0x00001fffffffffffULL, 0x00003fffffffffffULL, 0x00007fffffffffffULL,
+   0x0000ffffffffffffULL, 0x0001ffffffffffffULL, 0x0003ffffffffffffULL, 0x0007ffffffffffffULL,
+   0x000fffffffffffffULL, 0x001fffffffffffffULL, 0x003fffffffffffffULL, 0x007fffffffffffffULL,
+   0x00ffffffffffffffULL, 0x01ffffffffffffffULL, 0x03ffffffffffffffULL, 0x07ffffffffffffffULL,
+   0x0fffffffffffffffULL, 0x1fffffffffffffffULL, 0x3fffffffffffffffULL, 0x7fffffffffffffffULL,
+   0xffffffffffffffffULL
+};
+
 
 //////////////////
 //              //
@@ -106,9 +140,41 @@
 void bitops_copy(uint8_t * dst, uint8_t * src, uint32_t len, uint32_t offset,
    uint32_t n);
 
+// copies a series of bits between arbitrary bit offsets of two buffers
+void bitops_copy_bits(uint8_t * dst, size_t dst_offset, const uint8_t * src,
+   size_t src_offset, size_t n);
+
+// extracts a series of bits from an arbitrary bit offset into a buffer
+void bitops_extract(uint8_t * dst, const uint8_t * src, size_t offset,
+   size_t n);
+
+// reads up to 64 bits from an arbitrary bit offset of a buffer
+uint64_t bitops_load_bits(const uint8_t * src, size_t offset, size_t n);
+
+// reads 64 bits as a little endian word
+uint64_t bitops_load64(const uint8_t * src);
+
+// writes up to 64 bits to a byte aligned bit offset of a buffer
+void bitops_store_bits(uint8_t * dst, size_t offset, uint64_t data,
+   size_t n);
+
 // main statement
 int main(int argc, char * argv[]);
 
+// applies the bit insertions listed in a batch file to a buffer
+int my_batch(const char * file, uint8_t ** buffp, uint32_t * lenp,
+   int fixed, uint32_t verbose);
+
+// verifies and times the bit copy routines
+int my_benchmark(void);
+
+// returns seconds elapsed since timestamp and resets timestamp
+double my_elapsed(struct timespec * tsp);
+
+// copies bits one at a time for use as a reference
+void my_reference_copy(uint8_t * dst, size_t dst_offset, const uint8_t * src,
+   size_t src_offset, size_t n);
+
 // determines endianness of platform
 int32_t my_make_littleendian(uint32_t data);
 
@@ -141,79 +207,224 @@ void bitops_copy(uint8_t * dst, uint8_t * src, uint32_t len, uint32_t offset,
    uint32_t n)
 {
    uint32_t byte_required;
-   uint32_t byte_offset;
-   uint32_t bit_offset;
-   uint32_t byte_n;
-   uint32_t bit_n;
-   uint32_t mask;
-   uint32_t pos;
-   uint32_t u;
 
    // preliminary calculations to determine limits
    byte_required  = ((offset + n) & 0x07) ? 1 : 0;
    byte_required  = ((offset + n) / 0x08) + byte_required;
-   byte_offset    = (offset / 0x08);
-   bit_offset     = (offset & 0x07);
-   byte_n         = (n / 0x08);
-   bit_n          = (n & 0x07);
 
-   if (dst == src)
-      return;
    if (byte_required > len)
       return;
 
-   pos = 0;
-   if (byte_n)
-   {
-      // generates a mask used for copying bits accross bit boundaries
-      mask = 0xFF;
-      for(u = 0; u < bit_offset; u++)
-         mask = (mask << 1) & 0xFF;
+   bitops_copy_bits(dst, offset, src, 0, n);
 
-      // copies first byte of data
-      dst[byte_offset]     = ((src[0] << bit_offset) & ( mask)) |
-                             ((dst[byte_offset])     & (~mask));
+   return;
+}
 
-      // copies middle bytes
-      for(pos = 1; pos < (byte_n); pos++)
-         dst[byte_offset+pos] = ((src[pos]   << (bit_offset))   &  (mask)) |
-                                ((src[pos-1] >> (8-bit_offset)) & (~mask));
 
-      // copies last byte on an even bit boundary
-      dst[byte_offset+pos] = ((dst[byte_offset+pos])         &  (mask)) |
-                             ((src[pos-1] >> (8-bit_offset)) & (~mask));
+/// copies a series of bits between arbitrary bit offsets of two buffers
+///
+/// Bits are numbered from the least significant bit of the first byte. The
+/// buffers may overlap, in which case the bits are copied as if through an
+/// intermediate buffer.
+///
+/// @param[in]  dst         pointer to destination buffer
+/// @param[in]  dst_offset  bit offset within the destination buffer
+/// @param[in]  src         pointer to source buffer
+/// @param[in]  src_offset  bit offset within the source buffer
+/// @param[in]  n           number of bits to copy
+void bitops_copy_bits(uint8_t * dst, size_t dst_offset, const uint8_t * src,
+   size_t src_offset, size_t n)
+{
+   size_t    head;
+   size_t    body;
+   size_t    tail;
+   size_t    pos;
+   size_t    shift;
+   uint8_t   last;
+   uint8_t   mask;
+   uintptr_t dst_bit;
+   uintptr_t src_bit;
+
+   if (!(n))
+      return;
 
+   // copies whole bytes with memmove() when both offsets are byte aligned
+   if ( (!(dst_offset & 0x07)) && (!(src_offset & 0x07)) )
+   {
+      dst  += dst_offset / 8;
+      src  += src_offset / 8;
+      tail  = n & 0x07;
+      last  = (tail) ? src[n / 8] : 0;
+      memmove(dst, src, n / 8);
+      if ((tail))
+      {
+         mask       = (uint8_t)bitops_mask[tail];
+         dst[n / 8] = (uint8_t)((dst[n / 8] & ~mask) | (last & mask));
+      };
+      return;
    };
 
-   if ((bit_offset) || (bit_n))
+   // splits the copy into bits before the first byte boundary of the
+   // destination, whole 64 bit words, and the remaining bits
+   head  = (8 - (dst_offset & 0x07)) & 0x07;
+   head  = (head < n) ? head : n;
+   body  = (n - head) & ~((size_t)63);
+   tail  = n - head - body;
+   shift = dst_offset & 0x07;
+
+   // overlapping buffers with the destination after the source are copied
+   // from the last word to the first so that source bits are read before
+   // they are overwritten
+   dst_bit = ((uintptr_t)dst * 8) + dst_offset;
+   src_bit = ((uintptr_t)src * 8) + src_offset;
+   if ( (dst_bit > src_bit) && (dst_bit < (src_bit + n)) )
    {
-      // generates a mask used to copy remaining least significant
-      // bits into the remaining least significant byte
-      mask = 0x00;
-      for(u = 0; u < bit_n; u++)
-         mask = ((mask << 1) | 0x01) & 0xFF;
-      for(u = 0; u < bit_offset; u++)
-         mask = (mask << 1) & 0xFF;
-
-      // copies remaining bits into the least significant
-      // byte (of remaining two bytes)
-      dst[byte_offset+pos]   = ((src[pos] << bit_offset) &  (mask)) |
-                               ((dst[byte_offset+pos])   & (~mask));
-
-      if ((bit_offset + bit_n) > 8)
+      if ((tail))
+         bitops_store_bits(dst, dst_offset + head + body,
+            bitops_load_bits(src, src_offset + head + body, tail), tail);
+      for(pos = head + body; pos > head; pos -= 64)
+         bitops_store_bits(dst, dst_offset + pos - 64,
+            bitops_load_bits(src, src_offset + pos - 64, (size_t)64), (size_t)64);
+      if ((head))
       {
-         // generates a mask used to copy remaining most significant
-         // bits into the remaining most significant byte
-         mask = 0x00;
-         for(u = 0; u < ((bit_n+bit_offset)%8); u++)
-            mask = ((mask << 1) | 0x01) & 0xFF;
-
-         // copies remaining bits into the most significant
-         // byte (of remaining two bytes)
-         u = 8-bit_offset;
-         dst[byte_offset+pos+1] = ((src[pos] >> u)          &  (mask)) |
-                                  ((dst[byte_offset+pos+1]) & (~mask));
+         mask = (uint8_t)(bitops_mask[head] << shift);
+         last = (uint8_t)(bitops_load_bits(src, src_offset, head) << shift);
+         dst[dst_offset / 8] = (uint8_t)((dst[dst_offset / 8] & ~mask) | (last & mask));
       };
+      return;
+   };
+
+   if ((head))
+   {
+      mask = (uint8_t)(bitops_mask[head] << shift);
+      last = (uint8_t)(bitops_load_bits(src, src_offset, head) << shift);
+      dst[dst_offset / 8] = (uint8_t)((dst[dst_offset / 8] & ~mask) | (last & mask));
+   };
+   for(pos = head; pos < (head + body); pos += 64)
+      bitops_store_bits(dst, dst_offset + pos,
+         bitops_load_bits(src, src_offset + pos, (size_t)64), (size_t)64);
+   if ((tail))
+      bitops_store_bits(dst, dst_offset + head + body,
+         bitops_load_bits(src, src_offset + head + body, tail), tail);
+
+   return;
+}
+
+
+/// extracts a series of bits from an arbitrary bit offset into a buffer
+///
+/// The bits are stored starting at the first bit of dst and the unused bits
+/// of the last byte are cleared, so dst must hold (n + 7) / 8 bytes.
+///
+/// @param[in]  dst      pointer to destination buffer
+/// @param[in]  src      pointer to source buffer
+/// @param[in]  offset   bit offset within the source buffer
+/// @param[in]  n        number of bits to extract
+void bitops_extract(uint8_t * dst, const uint8_t * src, size_t offset,
+   size_t n)
+{
+   size_t   pos;
+   size_t   u;
+   uint64_t data;
+
+   if (!(offset & 0x07))
+   {
+      memcpy(dst, &src[offset / 8], (n + 7) / 8);
+      if ((n & 0x07))
+         dst[n / 8] &= (uint8_t)bitops_mask[n & 0x07];
+      return;
+   };
+
+   for(pos = 0; (pos + 64) <= n; pos += 64, dst += 8)
+      bitops_store_bits(dst, 0, bitops_load_bits(src, offset + pos, (size_t)64), (size_t)64);
+
+   if (pos < n)
+   {
+      data = bitops_load_bits(src, offset + pos, n - pos);
+      for(u = 0; u < ((n - pos + 7) / 8); u++)
+         dst[u] = (uint8_t)(data >> (u * 8));
+   };
+
+   return;
+}
+
+
+/// reads up to 64 bits from an arbitrary bit offset of a buffer
+///
+/// Only the bytes which contain the requested bits are read.
+///
+/// @param[in]  src      pointer to buffer
+/// @param[in]  offset   bit offset within the buffer
+/// @param[in]  n        number of bits to read (1 to 64)
+uint64_t bitops_load_bits(const uint8_t * src, size_t offset, size_t n)
+{
+   size_t   u;
+   size_t   bytes;
+   size_t   shift;
+   uint64_t data;
+
+   src   += offset / 8;
+   shift  = offset & 0x07;
+   bytes  = (shift + n + 7) / 8;
+
+   if (bytes < 8)
+   {
+      for(u = 0, data = 0; u < bytes; u++)
+         data |= ((uint64_t)src[u]) << (u * 8);
+      return((data >> shift) & bitops_mask[n]);
+   };
+
+   data = bitops_load64(src) >> shift;
+   if (bytes > 8)
+      data |= ((uint64_t)src[8]) << (64 - shift);
+
+   return(data & bitops_mask[n]);
+}
+
+
+/// reads 64 bits as a little endian word
+/// @param[in]  src      pointer to buffer
+uint64_t bitops_load64(const uint8_t * src)
+{
+   return( ((uint64_t)src[0]      ) | ((uint64_t)src[1] <<  8) |
+           ((uint64_t)src[2] << 16) | ((uint64_t)src[3] << 24) |
+           ((uint64_t)src[4] << 32) | ((uint64_t)src[5] << 40) |
+           ((uint64_t)src[6] << 48) | ((uint64_t)src[7] << 56) );
+}
+
+
+/// writes up to 64 bits to a byte aligned bit offset of a buffer
+/// @param[in]  dst      pointer to buffer
+/// @param[in]  offset   bit offset within the buffer, must be a multiple of 8
+/// @param[in]  data     bits to write
+/// @param[in]  n        number of bits to write (1 to 64)
+void bitops_store_bits(uint8_t * dst, size_t offset, uint64_t data,
+   size_t n)
+{
+   size_t  u;
+   uint8_t mask;
+
+   dst += offset / 8;
+
+   if (n == 64)
+   {
+      dst[0] = (uint8_t)(data      );
+      dst[1] = (uint8_t)(data >>  8);
+      dst[2] = (uint8_t)(data >> 16);
+      dst[3] = (uint8_t)(data >> 24);
+      dst[4] = (uint8_t)(data >> 32);
+      dst[5] = (uint8_t)(data >> 40);
+      dst[6] = (uint8_t)(data >> 48);
+      dst[7] = (uint8_t)(data >> 56);
+      return;
+   };
+
+   for(u = 0; u < (n / 8); u++)
+      dst[u] = (uint8_t)(data >> (u * 8));
+   if ((n & 0x07))
+   {
+      mask   = (uint8_t)bitops_mask[n & 0x07];
+      dst[u] = (uint8_t)((dst[u] & ~mask) | ((data >> (u * 8)) & mask));
    };
 
    return;
@@ -227,6 +438,8 @@ int main(int argc, char * argv[])
 {
    int         c;
    int         opt_index;
+   int         fixed;
+   char      * batch;
    uint8_t   * buff;
    uint32_t    u;
    uint32_t    len;
@@ -236,9 +449,10 @@ int main(int argc, char * argv[])
    uint32_t    buff_len;
 
    // getopt options
-   static char   short_opt[] = "B:b:d:hL:l:O:o:Vv";
+   static char   short_opt[] = "B:b:d:f:hL:l:O:o:Vv";
    static struct option long_opt[] =
    {
+      {"benchmark",     no_argument, 0, 'T'},
       {"help",          no_argument, 0, 'h'},
       {"verbose",       no_argument, 0, 'v'},
       {"version",       no_argument, 0, 'V'},
@@ -247,6 +461,8 @@ int main(int argc, char * argv[])
 
    len      = 0;
    data     = 0;
+   fixed    = 0;
+   batch    = NULL;
    offset   = 0;
    verbose  = 0;
    buff_len = 40;
@@ -260,14 +476,19 @@ int main(int argc, char * argv[])
             break;
          case 'B':
             buff_len = (uint32_t)strtoul(optarg, NULL, 0);
+            fixed    = 1;
             break;
          case 'b':
             u        = (uint32_t)strtoul(optarg, NULL, 0);
             buff_len = (u & 0x07) ? ((u/8) + 1) : (u/8);
+            fixed    = 1;
             break;
          case 'd':
             data = (uint32_t)strtoul(optarg, NULL, 0);
             break;
+         case 'f':
+            batch = optarg;
+            break;
          case 'h':
             my_usage();
             return(0);
@@ -289,6 +510,8 @@ int main(int argc, char * argv[])
          case 'o':
             offset = (uint32_t)strtoul(optarg, NULL, 0);
             break;
+         case 'T':
+            return(my_benchmark());
          case 'V':
             my_version();
             return(0);
@@ -305,6 +528,32 @@ int main(int argc, char * argv[])
       };
    };
 
+   // batch mode writes raw binary to stdout, so messages go to stderr
+   if ((batch))
+   {
+      if ( (!(fixed)) )
+         buff_len = 0;
+      buff = NULL;
+      if ( (fixed) && (!(buff = calloc((size_t)buff_len, 1))) && (buff_len) )
+      {
+         perror("calloc()");
+         return(1);
+      };
+      if ((my_batch(batch, &buff, &buff_len, fixed, verbose)))
+      {
+         free(buff);
+         return(1);
+      };
+      if ( (buff_len) && (fwrite(buff, 1, (size_t)buff_len, stdout) != (size_t)buff_len) )
+      {
+         perror("fwrite()");
+         free(buff);
+         return(1);
+      };
+      free(buff);
+      return(0);
+   };
+
    if (verbose > 1)
       printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
    if (verbose > 2)
@@ -343,6 +592,283 @@ int main(int argc, char * argv[])
 }
 
 
+/// applies the bit insertions listed in a batch file to a buffer
+///
+/// Each line of the file holds one record of the form "data offset bits",
+/// which inserts the low order bits of data at the bit offset. Fields accept
+/// the same number formats as the -d, -o, and -l options.  Blank lines and
+/// text following a '#' are ignored. Unless the buffer size is fixed, the
+/// buffer is grown to hold the furthest record.
+///
+/// @param[in]  file     path of batch file, "-" reads from stdin
+/// @param[in]  buffp    reference to destination buffer
+/// @param[in]  lenp     reference to length of buffer in bytes
+/// @param[in]  fixed    non-zero if the buffer may not be resized
+/// @param[in]  verbose  verbose level
+int my_batch(const char * file, uint8_t ** buffp, uint32_t * lenp,
+   int fixed, uint32_t verbose)
+{
+   FILE         * fs;
+   char         * ptr;
+   char         * end;
+   uint8_t      * buff;
+   uint8_t        data[8];
+   unsigned long  line;
+   unsigned long  count;
+   uint64_t       value;
+   uint64_t       offset;
+   uint64_t       n;
+   uint64_t       size;
+   uint32_t       u;
+   char           str[MY_BATCH_LINE];
+
+   fs = stdin;
+   if ( (strcmp(file, "-")) && (!(fs = fopen(file, "r"))) )
+   {
+      fprintf(stderr, "%s: %s: ", PROGRAM_NAME, file);
+      perror("fopen()");
+      return(1);
+   };
+
+   line  = 0;
+   count = 0;
+   while((fgets(str, (int)sizeof(str), fs)))
+   {
+      line++;
+      if ( (!(strchr(str, '\n'))) && (!(feof(fs))) )
+      {
+         fprintf(stderr, "%s: %s:%lu: line too long\n", PROGRAM_NAME, file, line);
+         goto error;
+      };
+      if ((ptr = strchr(str, '#')))
+         ptr[0] = '\0';
+      for(ptr = &str[strlen(str)]; ((ptr > str) && (strchr(" \t\r\n", ptr[-1]))); ptr--)
+         ptr[-1] = '\0';
+      ptr = str;
+      while((ptr[0] == ' ') || (ptr[0] == '\t') || (ptr[0] == '\r') || (ptr[0] == '\n'))
+         ptr++;
+      if (ptr[0] == '\0')
+         continue;
+
+      // parses record
+      value  = strtoull(ptr, &end, 0);
+      offset = (end != ptr) ? strtoull((ptr = end), &end, 0) : 0;
+      n      = (end != ptr) ? strtoull((ptr = end), &end, 0) : 0;
+      if (end == ptr)
+      {
+         fprintf(stderr, "%s: %s:%lu: expected \"data offset bits\"\n", PROGRAM_NAME, file, line);
+         goto error;
+      };
+      while((end[0] == ' ') || (end[0] == '\t'))
+         end++;
+      if (end[0] != '\0')
+      {
+         fprintf(stderr, "%s: %s:%lu: unexpected text `%s'\n", PROGRAM_NAME, file, line, end);
+         goto error;
+      };
+      if (n > 64)
+      {
+         fprintf(stderr, "%s: %s:%lu: record longer than 64 bits\n", PROGRAM_NAME, file, line);
+         goto error;
+      };
+
+      // resizes buffer to hold record
+      size = (offset + n + 7) / 8;
+      if (size > (uint64_t)UINT32_MAX)
+      {
+         fprintf(stderr, "%s: %s:%lu: offset out of range\n", PROGRAM_NAME, file, line);
+         goto error;
+      };
+      if (size > (uint64_t)*lenp)
+      {
+         if ((fixed))
+         {
+            fprintf(stderr, "%s: %s:%lu: record exceeds buffer size\n", PROGRAM_NAME, file, line);
+            goto error;
+         };
+         if (!(buff = realloc(*buffp, (size_t)size)))
+         {
+            perror("realloc()");
+            goto error;
+         };
+         memset(&buff[*lenp], 0, (size_t)(size - *lenp));
+         *buffp = buff;
+         *lenp  = (uint32_t)size;
+      };
+
+      for(u = 0; u < 8; u++)
+         data[u] = (uint8_t)(value >> (u * 8));
+      bitops_copy_bits(*buffp, (size_t)offset, data, 0, (size_t)n);
+      count++;
+   };
+   if ((ferror(fs)))
+   {
+      fprintf(stderr, "%s: %s: ", PROGRAM_NAME, file);
+      perror("fgets()");
+      goto error;
+   };
+
+   if (verbose)
+      fprintf(stderr, "%s: applied %lu records to %u bytes\n", PROGRAM_NAME, count, *lenp);
+
+   if (fs != stdin)
+      fclose(fs);
+
+   return(0);
+
+   error:
+   if (fs != stdin)
+      fclose(fs);
+   return(1);
+}
+
+
+/// verifies and times the bit copy routines
+///
+/// Every combination of offsets 0 through 7 and lengths of 1 through
+/// MY_BENCH_BITS bits is checked against a bit by bit reference before the
+/// insert, extract, and reference routines are timed across the same set.
+int my_benchmark(void)
+{
+   size_t          offset;
+   size_t          n;
+   size_t          u;
+   size_t          bytes;
+   size_t          ops;
+   double          elapsed[3];
+   uint8_t       * src;
+   uint8_t       * dst;
+   uint8_t       * ref;
+   struct timespec ts;
+
+   bytes = (MY_BENCH_BITS / 8) + 2;
+   src   = malloc(bytes);
+   dst   = malloc(bytes);
+   ref   = malloc(bytes);
+   if ( (!(src)) || (!(dst)) || (!(ref)) )
+   {
+      perror("malloc()");
+      free(src);
+      free(dst);
+      free(ref);
+      return(1);
+   };
+   srand(1);
+   for(u = 0; u < bytes; u++)
+      src[u] = (uint8_t)rand();
+
+   printf("%s: offsets 0-7, lengths 1-%u bits\n", PROGRAM_NAME, MY_BENCH_BITS);
+
+   // verifies routines against reference
+   for(offset = 0; offset < 8; offset++)
+   {
+      for(n = 1; n <= MY_BENCH_BITS; n++)
+      {
+         memset(dst, 0xa5, bytes);
+         memset(ref, 0xa5, bytes);
+         bitops_copy_bits(dst, offset, src, 0, n);
+         my_reference_copy(ref, offset, src, 0, n);
+         if ((memcmp(dst, ref, bytes)))
+         {
+            fprintf(stderr, "%s: insert mismatch at offset %zu, %zu bits\n", PROGRAM_NAME, offset, n);
+            goto error;
+         };
+
+         memset(dst, 0xa5, bytes);
+         memset(ref, 0x00, bytes);
+         bitops_extract(dst, src, offset, n);
+         my_reference_copy(ref, 0, src, offset, n);
+         if ((memcmp(dst, ref, (n + 7) / 8)))
+         {
+            fprintf(stderr, "%s: extract mismatch at offset %zu, %zu bits\n", PROGRAM_NAME, offset, n);
+            goto error;
+         };
+      };
+   };
+   printf("   %-10s %s\n", "verify:", "ok");
+
+   // times routines
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   for(u = 0; u < MY_BENCH_ROUNDS; u++)
+      for(offset = 0; offset < 8; offset++)
+         for(n = 1; n <= MY_BENCH_BITS; n++)
+            bitops_copy_bits(dst, offset, src, 0, n);
+   elapsed[0] = my_elapsed(&ts);
+   for(u = 0; u < MY_BENCH_ROUNDS; u++)
+      for(offset = 0; offset < 8; offset++)
+         for(n = 1; n <= MY_BENCH_BITS; n++)
+            bitops_extract(dst, src, offset, n);
+   elapsed[1] = my_elapsed(&ts);
+   for(u = 0; u < MY_BENCH_ROUNDS; u++)
+      for(offset = 0; offset < 8; offset++)
+         for(n = 1; n <= MY_BENCH_BITS; n++)
+            my_reference_copy(ref, offset, src, 0, n);
+   elapsed[2] = my_elapsed(&ts);
+
+   // reports results, average length is half of MY_BENCH_BITS
+   ops = (size_t)MY_BENCH_ROUNDS * 8 * MY_BENCH_BITS;
+   printf("   %-10s %9.1f ns/op %9.1f MB/s\n", "insert:",
+      (elapsed[0] * 1e9) / (double)ops, ((double)ops * MY_BENCH_BITS / 16) / (elapsed[0] * 1e6));
+   printf("   %-10s %9.1f ns/op %9.1f MB/s\n", "extract:",
+      (elapsed[1] * 1e9) / (double)ops, ((double)ops * MY_BENCH_BITS / 16) / (elapsed[1] * 1e6));
+   printf("   %-10s %9.1f ns/op %9.1f MB/s\n", "reference:",
+      (elapsed[2] * 1e9) / (double)ops, ((double)ops * MY_BENCH_BITS / 16) / (elapsed[2] * 1e6));
+
+   free(src);
+   free(dst);
+   free(ref);
+   return(0);
+
+   error:
+   free(src);
+   free(dst);
+   free(ref);
+   return(1);
+}
+
+
+/// returns seconds elapsed since timestamp and resets timestamp
+/// @param[in]  tsp   pointer to timestamp
+double my_elapsed(struct timespec * tsp)
+{
+   struct timespec now;
+   double          elapsed;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   elapsed  = (double)(now.tv_sec  - tsp->tv_sec);
+   elapsed += (double)(now.tv_nsec - tsp->tv_nsec) / 1000000000.0;
+   *tsp     = now;
+
+   return(elapsed);
+}
+
+
+/// copies bits one at a time for use as a reference
+/// @param[in]  dst         pointer to destination buffer
+/// @param[in]  dst_offset  bit offset within the destination buffer
+/// @param[in]  src         pointer to source buffer
+/// @param[in]  src_offset  bit offset within the source buffer
+/// @param[in]  n           number of bits to copy
+void my_reference_copy(uint8_t * dst, size_t dst_offset, const uint8_t * src,
+   size_t src_offset, size_t n)
+{
+   size_t  u;
+   size_t  d;
+   size_t  s;
+   uint8_t bit;
+
+   for(u = 0; u < n; u++)
+   {
+      d   = dst_offset + u;
+      s   = src_offset + u;
+      bit = (uint8_t)((src[s / 8] >> (s & 0x07)) & 0x01);
+      dst[d / 8] = (uint8_t)((dst[d / 8] & ~(0x01 << (d & 0x07))) | (bit << (d & 0x07)));
+   };
+
+   return;
+}
+
+
 // determines endianness of platform
 int32_t my_make_littleendian(uint32_t data)
 {
@@ -363,7 +889,9 @@ void my_usage()
    printf("  -B bytes                  size of buffer to use\n");
    printf("  -b bits                   size of buffer to use\n");
    printf("  -d data                   data to insert\n");
+   printf("  -f file                   apply insertions listed in file and write raw binary\n");
    printf("  -h, --help                print this help and exit\n");
+   printf("  --benchmark               verify and time the bit copy routines\n");
    printf("  -L bytes                  length of data in bytes\n");
    printf("  -l bits                   length of data in bits\n");
    printf("  -O bytes                  offset in bytes to store data\n");
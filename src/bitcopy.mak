@@ -2,6 +2,9 @@ bitcopy: Makefile bitcopy.c bitcopy.mak
 	$(LIBTOOL) --mode=compile --tag=CC $(CC) $(CFLAGS) -c bitcopy.c
 	$(LIBTOOL) --mode=link    --tag=CC $(CC) $(CFLAGS) -o bitcopy bitcopy.lo
 
+bitcopy-bench: bitcopy
+	./bitcopy --benchmark
+
 bitcopy-clean:
 	$(LIBTOOL) --mode=clean rm -f bitcopy.lo bitcopy
 
@@ -37,17 +37,19 @@
 /*
  *  Simple Build:
  *     gcc -W -Wall -O2 -c codetagger.c
- *     gcc -W -Wall -O2 -o codetagger   codetagger.o
+ *     gcc -W -Wall -O2 -c walk.c
+ *     gcc -W -Wall -O2 -o codetagger   codetagger.o walk.o -lpthread
  *
  *  GNU Libtool Build:
  *     libtool --mode=compile gcc -W -Wall -g -O2 -c codetagger.c
- *     libtool --mode=link    gcc -W -Wall -g -O2 -o codetagger codetagger.lo
+ *     libtool --mode=compile gcc -W -Wall -g -O2 -c walk.c
+ *     libtool --mode=link    gcc -W -Wall -g -O2 -o codetagger codetagger.lo walk.lo -lpthread
  *
  *  GNU Libtool Install:
  *     libtool --mode=install install -c codetagger /usr/local/bin/codetagger
  *
  *  GNU Libtool Clean:
- *     libtool --mode=clean rm -f codetagger.lo codetagger
+ *     libtool --mode=clean rm -f codetagger.lo walk.lo codetagger
  */
 #define _DMSTOOLS_SRC_CODINGTAGGER_C 1
 
@@ -60,10 +62,13 @@
 #ifdef HAVE_COMMON_H
 #include "common.h"
 #endif
+#include "walk.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <dirent.h>
 #include <getopt.h>
 #include <fcntl.h>
@@ -74,6 +79,7 @@
 #include <stdarg.h>
 #include <regex.h>
 #include <errno.h>
+#include <time.h>
 
 
 ///////////////////
@@ -107,10 +113,30 @@
 #define CODETAGGER_OPT_RECURSE     0x0040
 #define CODETAGGER_OPT_TEST        0x0080
 #define CODETAGGER_OPT_VERBOSE     0x0100
+#define CODETAGGER_OPT_STATS       0x0200
+#define CODETAGGER_OPT_STREAM      0x0400
 
 #undef  CODETAGGER_STR_LEN
 #define CODETAGGER_STR_LEN  ((size_t)512)
 
+#define CODETAGGER_TAG_COMPILED    0x0001
+#define CODETAGGER_TAG_MAPPED      0x0002
+
+#undef  CODETAGGER_BIN_MAGIC
+#define CODETAGGER_BIN_MAGIC       "CTAGBIN"
+#undef  CODETAGGER_BIN_VERSION
+#define CODETAGGER_BIN_VERSION     1
+#undef  CODETAGGER_BIN_ORDER
+#define CODETAGGER_BIN_ORDER       0x01020304
+
+#undef  CODETAGGER_MAX_BUFFER
+#define CODETAGGER_MAX_BUFFER      ((size_t)(1024*1024*10))
+#undef  CODETAGGER_STREAM_CHUNK
+#define CODETAGGER_STREAM_CHUNK    ((size_t)(1024*1024))
+
+#undef  CODETAGGER_DIFF_CONTEXT
+#define CODETAGGER_DIFF_CONTEXT  ((size_t)3)
+
 #ifndef PARAMS
 #define PARAMS(protos) protos
 #endif
@@ -128,10 +154,85 @@ struct codetagger_data
 {
    char     * name;
    char    ** contents;
+   const char * pattern;                 ///< uncompiled END tag regex of mapped tag
+   unsigned   flags;
    regex_t    regex;
 };
 
 
+/// header of compiled tag file
+typedef struct codetagger_bin_header CodeTaggerBinHeader;
+struct codetagger_bin_header
+{
+   char       magic[8];                  ///< identifies file as a compiled tag file
+   uint32_t   version;                   ///< version of compiled tag file format
+   uint32_t   byte_order;                ///< detects files compiled with a different byte order
+   uint32_t   tag_count;                 ///< number of tag records following header
+   uint32_t   line_count;                ///< number of line records following tag records
+   uint32_t   pool_size;                 ///< size of string pool following line records
+   uint32_t   left_tag;                  ///< pool offset of left enclosing string
+   uint32_t   right_tag;                 ///< pool offset of right enclosing string
+   uint32_t   reserved;
+};
+
+
+/// tag record of compiled tag file
+typedef struct codetagger_bin_tag CodeTaggerBinTag;
+struct codetagger_bin_tag
+{
+   uint32_t   name;                      ///< pool offset of tag name
+   uint32_t   pattern;                   ///< pool offset of END tag regex
+   uint32_t   line_first;                ///< index of first line record of tag body
+   uint32_t   line_count;                ///< number of lines in tag body
+};
+
+
+/// region of a file replaced by a tag expansion
+typedef struct codetagger_region CodeTaggerRegion;
+struct codetagger_region
+{
+   size_t     orig_start;                ///< offset of region in original file
+   size_t     orig_end;                  ///< offset of end of region in original file
+   size_t     modd_start;                ///< offset of region in updated file
+   size_t     modd_end;                  ///< offset of end of region in updated file
+};
+
+
+/// state of file being processed in streaming mode
+typedef struct codetagger_stream CodeTaggerStream;
+struct codetagger_stream
+{
+   int               fd;                 ///< descriptor of temporary output file
+   int               changed;            ///< output differs from input
+   int               overlong;           ///< current line is longer than a chunk
+   size_t            offset;             ///< offset of current line in input file
+   size_t            written;            ///< number of bytes written to output
+   size_t            exp_len;            ///< length of expansion of current tag
+   size_t            exp_pos;            ///< bytes of input compared against expansion
+   size_t            exp_size;           ///< size of expansion buffer
+   char            * exp;                ///< expansion of current tag
+   const char      * filename;           ///< name of file being processed
+   CodeTaggerData  * tag;                ///< tag being expanded, NULL if copying input
+   struct timespec   ts;                 ///< timestamp of last phase change
+};
+
+
+/// processing statistics
+typedef struct codetagger_stats CodeTaggerStats;
+struct codetagger_stats
+{
+   size_t            files_scanned;      ///< number of regular files processed
+   size_t            files_skipped;      ///< number of files ignored or failed
+   size_t            files_changed;      ///< number of files updated
+   size_t            tags_expanded;      ///< number of tags expanded
+   size_t            bytes_written;      ///< number of bytes written to updated files
+   double            time_walk;          ///< seconds spent walking directories
+   double            time_read;          ///< seconds spent reading files
+   double            time_match;         ///< seconds spent matching and expanding tags
+   double            time_write;         ///< seconds spent writing files or diffs
+};
+
+
 /// config data
 typedef struct codetagger_config CodeTagger;
 struct codetagger_config
@@ -145,10 +246,17 @@ struct codetagger_config
    char            * buff_orig;          ///< buffer for original file
    char            * buff_modd;          ///< buffer for updated file
    const char      * tagFile;
+   const char      * compileFile;        ///< file to which compiled tags are written
    const char      * leftTagString;
    const char      * rightTagString;
    regex_t           generic_tag;        ///< generic regex for finding start tag
    CodeTaggerData ** tagList;
+   size_t            region_count;       ///< number of expanded regions in current file
+   size_t            region_size;        ///< size of array of expanded regions
+   CodeTaggerRegion * regions;           ///< expanded regions in current file
+   CodeTaggerStats   stats;              ///< processing statistics
+   void            * tag_map;            ///< mapped compiled tag file
+   size_t            tag_map_len;        ///< length of mapped compiled tag file
 };
 
 
@@ -166,6 +274,24 @@ int codetagger_buffer_resize PARAMS((CodeTagger * cnf, size_t size,
 int codetagger_buffer_write PARAMS((CodeTagger * cnf, const char * src,
    size_t len, const char * filename));
 
+// builds regular expression which matches the END tag of a tag pair
+void codetagger_build_tag_regex PARAMS((CodeTagger * cnf, char * regstr,
+   const char * tagName));
+
+// writes parsed tags to a compiled tag file
+int codetagger_compile_tag_file PARAMS((CodeTagger * cnf));
+
+// compiles END tag regular expression of tag if not already compiled
+int codetagger_compile_tag PARAMS((CodeTagger * cnf, CodeTaggerData * tag));
+
+// compares two lines from the original and updated file
+int codetagger_diff_line_cmp PARAMS((CodeTagger * cnf, const size_t * orig_lines,
+   size_t orig_line, const size_t * modd_lines, size_t modd_line));
+
+// finds line of buffer containing offset
+size_t codetagger_diff_line_find PARAMS((const size_t * lines, size_t count,
+   size_t offset));
+
 // prints debug messages
 #define codetagger_debug(cnf)           codetagger_debug_trace(cnf, __func__, NULL)
 #define codetagger_debug_ext(cnf, ...)  codetagger_debug_trace(cnf, __func__, __VA_ARGS__)
@@ -175,6 +301,9 @@ void codetagger_debug_trace PARAMS((CodeTagger * cnf, const char * func,
 // prints error message
 void codetagger_error PARAMS((CodeTagger * cnf, const char * fmt, ...));
 
+// returns seconds elapsed since timestamp and resets timestamp
+double codetagger_elapsed PARAMS((struct timespec * tsp));
+
 // creates a regex safe string (escapes chracters meaning full in regex)
 int codetagger_escape_string PARAMS((CodeTagger * cnf, char * buff,
    const char * str, size_t len));
@@ -191,12 +320,36 @@ void codetagger_free_taglist PARAMS((CodeTagger * cnf, CodeTaggerData ** taglist
 // reads file into an array
 char ** codetagger_get_file_contents PARAMS((CodeTagger * cnf, const char * file));
 
+// builds array of offsets to the start of each line in buffer
+size_t * codetagger_index_lines PARAMS((const char * buff, size_t len,
+   size_t * countp));
+
+// loads tags from a compiled tag file
+int codetagger_load_tag_file PARAMS((CodeTagger * cnf));
+
+// releases tags loaded from a compiled tag file and unmaps the file
+void codetagger_unload_tag_file PARAMS((CodeTagger * cnf));
+
 // generate array of tags from file
 int codetagger_parse_tag_file PARAMS((CodeTagger * cnf));
 
 // prepares generic regular expressions
 int codetagger_prepare_regex PARAMS((CodeTagger * cnf));
 
+// prints unified diff of original and updated file
+int codetagger_print_diff PARAMS((CodeTagger * cnf, const char * filename));
+
+// prints lines of file with a unified diff prefix
+void codetagger_print_diff_lines PARAMS((char prefix, const char * buff,
+   const size_t * lines, size_t count, size_t start, size_t end));
+
+// prints processing statistics
+void codetagger_print_stats PARAMS((CodeTagger * cnf));
+
+// records region of file replaced by tag expansion
+int codetagger_record_region PARAMS((CodeTagger * cnf, size_t orig_start,
+   size_t orig_end, size_t modd_start));
+
 // retrieves a specific tag from the tag list
 CodeTaggerData * codetagger_retrieve_tag_data PARAMS((CodeTagger * cnf,
    const char * tagName, const char * fileName, int lineNumber));
@@ -204,14 +357,38 @@ CodeTaggerData * codetagger_retrieve_tag_data PARAMS((CodeTagger * cnf,
 // recursively scans directory for files to update
 int codetagger_scan_directory PARAMS((CodeTagger * cnf, const char * origin));
 
-// scan file to determine wether to attempt and update
-int codetagger_scan_file PARAMS((CodeTagger * cnf, const char * file,
-   size_t * countp, char *** queuep, size_t * sizep));
+// scan entry to determine wether to attempt and update
+int codetagger_scan_entry PARAMS((const WalkEntry * entry, void * data));
 
 // updates original file by inserting/expanding tags
 int codetagger_update_file PARAMS((CodeTagger * cnf, const char * filename,
    struct stat * sbp));
 
+// appends data to expansion of current tag
+int codetagger_stream_append PARAMS((CodeTagger * cnf, CodeTaggerStream * st,
+   const char * src, size_t len));
+
+// copies updated temporary file into original file
+int codetagger_stream_copy PARAMS((CodeTagger * cnf, const char * tmpfile,
+   const char * filename));
+
+// updates file by processing it in fixed size chunks
+int codetagger_stream_file PARAMS((CodeTagger * cnf, const char * filename));
+
+// writes buffered output to temporary file
+int codetagger_stream_flush PARAMS((CodeTagger * cnf, CodeTaggerStream * st));
+
+// processes a single line of a streamed file
+int codetagger_stream_line PARAMS((CodeTagger * cnf, CodeTaggerStream * st,
+   char * line, size_t len, int newline));
+
+// appends data to buffered output of streamed file
+int codetagger_stream_write PARAMS((CodeTagger * cnf, CodeTaggerStream * st,
+   const char * src, size_t len));
+
+// writes entire buffer to file descriptor
+int codetagger_write_full PARAMS((int fd, const char * buff, size_t len));
+
 // displays usage
 void codetagger_usage PARAMS((void));
 
@@ -251,7 +428,7 @@ int codetagger_buffer_resize(CodeTagger * cnf, size_t size,
    if (cnf->buff_size > size)
       return(0);
 
-   if (size > (1024*1024*10))
+   if (size > CODETAGGER_MAX_BUFFER)
    {
       if (error_prefix)
          codetagger_error(cnf, "%s: exceeded memory limits\n", error_prefix);
@@ -305,6 +482,160 @@ int codetagger_buffer_write(CodeTagger * cnf, const char * src, size_t len,
 }
 
 
+/// builds regular expression which matches the END tag of a tag pair
+/// @param[in]  cnf      pointer to config data structure
+/// @param[out] regstr   buffer of CODETAGGER_STR_LEN bytes for the regex
+/// @param[in]  tagName  name of tag
+void codetagger_build_tag_regex(CodeTagger * cnf, char * regstr,
+   const char * tagName)
+{
+   memset(regstr, 0, CODETAGGER_STR_LEN);
+   codetagger_escape_string(cnf, regstr, cnf->leftTagString,  CODETAGGER_STR_LEN);
+   strncat(regstr,       "(",                 CODETAGGER_STR_LEN);
+   strncat(regstr,       tagName,             CODETAGGER_STR_LEN);
+   strncat(regstr,       "END",               CODETAGGER_STR_LEN);
+   strncat(regstr,       ")",                 CODETAGGER_STR_LEN);
+   codetagger_escape_string(cnf, regstr, cnf->rightTagString, CODETAGGER_STR_LEN);
+   return;
+}
+
+
+/// compiles END tag regular expression of tag if not already compiled
+/// @param[in]  cnf   pointer to config data structure
+/// @param[in]  tag   tag data structure
+int codetagger_compile_tag(CodeTagger * cnf, CodeTaggerData * tag)
+{
+   int           err;
+   char          errmsg[CODETAGGER_STR_LEN];
+
+   if ((tag->flags & CODETAGGER_TAG_COMPILED))
+      return(0);
+
+   codetagger_debug_ext(cnf, "%s", tag->name);
+
+   if ((err = regcomp(&tag->regex, tag->pattern, REG_EXTENDED|REG_ICASE)))
+   {
+      regerror(err, &tag->regex, errmsg, CODETAGGER_STR_LEN-1);
+      fprintf(stderr, PROGRAM_NAME ": regex error: %s\n", errmsg);
+      return(-1);
+   };
+   tag->flags |= CODETAGGER_TAG_COMPILED;
+
+   return(0);
+}
+
+
+/// writes parsed tags to a compiled tag file
+/// @param[in]  cnf   pointer to config data structure
+int codetagger_compile_tag_file(CodeTagger * cnf)
+{
+   int                   fd;
+   size_t                u;
+   size_t                x;
+   size_t                len;
+   size_t                size;
+   size_t                line_count;
+   size_t                pool_size;
+   char                * buff;
+   char                * pool;
+   char                  regstr[CODETAGGER_STR_LEN];
+   uint32_t            * lines;
+   CodeTaggerBinHeader * hdr;
+   CodeTaggerBinTag    * rec;
+
+   codetagger_debug(cnf);
+
+   // calculates size of compiled tag file
+   line_count = 0;
+   pool_size  = strlen(cnf->leftTagString) + strlen(cnf->rightTagString) + 2;
+   for(u = 0; u < cnf->tagCount; u++)
+   {
+      codetagger_build_tag_regex(cnf, regstr, cnf->tagList[u]->name);
+      pool_size += strlen(cnf->tagList[u]->name) + strlen(regstr) + 2;
+      for(x = 0; cnf->tagList[u]->contents[x]; x++)
+         pool_size += strlen(cnf->tagList[u]->contents[x]) + 1;
+      line_count += x;
+   };
+   size  = sizeof(CodeTaggerBinHeader);
+   size += sizeof(CodeTaggerBinTag) * cnf->tagCount;
+   size += sizeof(uint32_t) * line_count;
+   size += pool_size;
+   if (size > UINT32_MAX)
+   {
+      codetagger_error(cnf, "%s: exceeded memory limits\n", cnf->compileFile);
+      return(1);
+   };
+
+   if (!(buff = calloc((size_t)1, size)))
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      return(-1);
+   };
+   hdr   = (CodeTaggerBinHeader *)buff;
+   rec   = (CodeTaggerBinTag *)&hdr[1];
+   lines = (uint32_t *)&rec[cnf->tagCount];
+   pool  = (char *)&lines[line_count];
+
+   // populates header
+   memcpy(hdr->magic, CODETAGGER_BIN_MAGIC, sizeof(CODETAGGER_BIN_MAGIC));
+   hdr->version    = CODETAGGER_BIN_VERSION;
+   hdr->byte_order = CODETAGGER_BIN_ORDER;
+   hdr->tag_count  = (uint32_t)cnf->tagCount;
+   hdr->line_count = (uint32_t)line_count;
+   hdr->pool_size  = (uint32_t)pool_size;
+
+   // copies strings into string pool
+   len = 0;
+   hdr->left_tag  = (uint32_t)len;
+   strcpy(&pool[len], cnf->leftTagString);
+   len += strlen(cnf->leftTagString) + 1;
+   hdr->right_tag = (uint32_t)len;
+   strcpy(&pool[len], cnf->rightTagString);
+   len += strlen(cnf->rightTagString) + 1;
+   line_count = 0;
+   for(u = 0; u < cnf->tagCount; u++)
+   {
+      rec[u].name = (uint32_t)len;
+      strcpy(&pool[len], cnf->tagList[u]->name);
+      len += strlen(cnf->tagList[u]->name) + 1;
+
+      codetagger_build_tag_regex(cnf, regstr, cnf->tagList[u]->name);
+      rec[u].pattern = (uint32_t)len;
+      strcpy(&pool[len], regstr);
+      len += strlen(regstr) + 1;
+
+      rec[u].line_first = (uint32_t)line_count;
+      for(x = 0; cnf->tagList[u]->contents[x]; x++)
+      {
+         lines[line_count++] = (uint32_t)len;
+         strcpy(&pool[len], cnf->tagList[u]->contents[x]);
+         len += strlen(cnf->tagList[u]->contents[x]) + 1;
+      };
+      rec[u].line_count = (uint32_t)x;
+   };
+
+   codetagger_verbose(cnf, "compiling \"%s\"\n", cnf->compileFile);
+
+   if ((fd = open(cnf->compileFile, O_WRONLY|O_TRUNC|O_CREAT, 0644)) == -1)
+   {
+      codetagger_error(cnf, "%s: %s\n", cnf->compileFile, strerror(errno));
+      free(buff);
+      return(1);
+   };
+   if (write(fd, buff, size) != (ssize_t)size)
+   {
+      codetagger_error(cnf, "%s: %s\n", cnf->compileFile, strerror(errno));
+      close(fd);
+      free(buff);
+      return(1);
+   };
+   close(fd);
+   free(buff);
+
+   return(0);
+}
+
+
 /// prints debug messages
 /// @param[in]  cnf   pointer to config data structure
 /// @param[in]  func  name of calling function
@@ -336,6 +667,22 @@ void codetagger_debug_trace(CodeTagger * cnf, const char * func, const char * fm
 }
 
 
+/// returns seconds elapsed since timestamp and resets timestamp
+/// @param[in]  tsp   pointer to timestamp
+double codetagger_elapsed(struct timespec * tsp)
+{
+   struct timespec now;
+   double          elapsed;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   elapsed  = (double)(now.tv_sec  - tsp->tv_sec);
+   elapsed += (double)(now.tv_nsec - tsp->tv_nsec) / 1000000000.0;
+   *tsp     = now;
+
+   return(elapsed);
+}
+
+
 /// prints error message
 /// @param[in]  cnf    pointer to config data structure
 /// @param[in]  fmt    the format string of the message
@@ -424,14 +771,18 @@ void codetagger_free_tag(CodeTagger * cnf, CodeTaggerData * tag)
    if (!(tag))
       return;
 
-   if (tag->name)
+   // strings of mapped tags reside in the compiled tag file
+   if ((tag->name) && (!(tag->flags & CODETAGGER_TAG_MAPPED)))
       free(tag->name);
 
+   if ((tag->flags & CODETAGGER_TAG_COMPILED))
+      regfree(&tag->regex);
+
    if (tag->contents)
    {
-      regfree(&tag->regex);
-      for(i = 0; tag->contents[i]; i++)
-         free(tag->contents[i]);
+      if (!(tag->flags & CODETAGGER_TAG_MAPPED))
+         for(i = 0; tag->contents[i]; i++)
+            free(tag->contents[i]);
       free(tag->contents);
    };
 
@@ -535,6 +886,206 @@ char ** codetagger_get_file_contents(CodeTagger * cnf, const char * file)
 }
 
 
+/// builds array of offsets to the start of each line in buffer
+/// @param[in]  buff    buffer to index
+/// @param[in]  len     length of data in buffer
+/// @param[out] countp  number of lines in buffer
+size_t * codetagger_index_lines(const char * buff, size_t len, size_t * countp)
+{
+   size_t    pos;
+   size_t    count;
+   size_t  * lines;
+
+   count = 0;
+   for(pos = 0; pos < len; pos++)
+      if (buff[pos] == '\n')
+         count++;
+   if ((len > 0) && (buff[len-1] != '\n'))
+      count++;
+
+   if (!(lines = malloc(sizeof(size_t) * (count + 1))))
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      return(NULL);
+   };
+
+   // the entry following the last line marks the end of the buffer
+   count = 0;
+   if (len > 0)
+      lines[count++] = 0;
+   for(pos = 0; pos < len; pos++)
+      if ((buff[pos] == '\n') && ((pos+1) < len))
+         lines[count++] = pos + 1;
+   lines[count] = len;
+
+   *countp = count;
+
+   return(lines);
+}
+
+
+/// loads tags from a compiled tag file
+/// @param[in]  cnf   pointer to config data structure
+/// @return Returns 0 if the tags were loaded, 1 if the tag file is not a
+///         compiled tag file, and -1 on error.
+int codetagger_load_tag_file(CodeTagger * cnf)
+{
+   int                   fd;
+   size_t                u;
+   size_t                x;
+   size_t                size;
+   char                * pool;
+   uint32_t            * lines;
+   struct stat           sb;
+   CodeTaggerData      * tag;
+   CodeTaggerBinHeader * hdr;
+   CodeTaggerBinTag    * rec;
+
+   codetagger_debug(cnf);
+
+   if ((fd = open(cnf->tagFile, O_RDONLY)) == -1)
+   {
+      codetagger_error(cnf, "%s: %s\n", cnf->tagFile, strerror(errno));
+      return(-1);
+   };
+   if ((fstat(fd, &sb)) == -1)
+   {
+      codetagger_error(cnf, "%s: %s\n", cnf->tagFile, strerror(errno));
+      close(fd);
+      return(-1);
+   };
+   if ((size_t)sb.st_size < sizeof(CodeTaggerBinHeader))
+   {
+      close(fd);
+      return(1);
+   };
+   if ((hdr = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+   {
+      codetagger_error(cnf, "%s: %s\n", cnf->tagFile, strerror(errno));
+      close(fd);
+      return(-1);
+   };
+   close(fd);
+   if ((memcmp(hdr->magic, CODETAGGER_BIN_MAGIC, sizeof(CODETAGGER_BIN_MAGIC))))
+   {
+      munmap(hdr, (size_t)sb.st_size);
+      return(1);
+   };
+   cnf->tag_map     = hdr;
+   cnf->tag_map_len = (size_t)sb.st_size;
+
+   codetagger_verbose(cnf, "loading \"%s\"\n", cnf->tagFile);
+
+   // verifies layout of compiled tag file
+   if ((hdr->version != CODETAGGER_BIN_VERSION) || (hdr->byte_order != CODETAGGER_BIN_ORDER))
+   {
+      codetagger_error(cnf, "%s: unsupported compiled tag file\n", cnf->tagFile);
+      codetagger_unload_tag_file(cnf);
+      return(-1);
+   };
+   size  = sizeof(CodeTaggerBinHeader);
+   size += sizeof(CodeTaggerBinTag) * (size_t)hdr->tag_count;
+   size += sizeof(uint32_t) * (size_t)hdr->line_count;
+   size += (size_t)hdr->pool_size;
+   if ((size != cnf->tag_map_len) || (!(hdr->pool_size)))
+   {
+      codetagger_error(cnf, "%s: corrupt compiled tag file\n", cnf->tagFile);
+      codetagger_unload_tag_file(cnf);
+      return(-1);
+   };
+   rec   = (CodeTaggerBinTag *)&hdr[1];
+   lines = (uint32_t *)&rec[hdr->tag_count];
+   pool  = (char *)&lines[hdr->line_count];
+   if (pool[hdr->pool_size-1] != '\0')
+   {
+      codetagger_error(cnf, "%s: corrupt compiled tag file\n", cnf->tagFile);
+      codetagger_unload_tag_file(cnf);
+      return(-1);
+   };
+   for(u = 0; u < hdr->tag_count; u++)
+   {
+      if ( (rec[u].name >= hdr->pool_size) || (rec[u].pattern >= hdr->pool_size) ||
+           (rec[u].line_first > hdr->line_count) ||
+           (rec[u].line_count > (hdr->line_count - rec[u].line_first)) )
+      {
+         codetagger_error(cnf, "%s: corrupt compiled tag file\n", cnf->tagFile);
+         codetagger_unload_tag_file(cnf);
+         return(-1);
+      };
+   };
+   for(u = 0; u < hdr->line_count; u++)
+   {
+      if (lines[u] >= hdr->pool_size)
+      {
+         codetagger_error(cnf, "%s: corrupt compiled tag file\n", cnf->tagFile);
+         codetagger_unload_tag_file(cnf);
+         return(-1);
+      };
+   };
+
+   // tags are only valid with the enclosing strings used to compile them
+   if ( (hdr->left_tag >= hdr->pool_size) || (hdr->right_tag >= hdr->pool_size) ||
+        (strcmp(&pool[hdr->left_tag], cnf->leftTagString)) ||
+        (strcmp(&pool[hdr->right_tag], cnf->rightTagString)) )
+   {
+      codetagger_error(cnf, "%s: compiled with enclosing strings \"%s\" and \"%s\"\n",
+         cnf->tagFile, &pool[hdr->left_tag], &pool[hdr->right_tag]);
+      codetagger_unload_tag_file(cnf);
+      return(-1);
+   };
+
+   if (!(cnf->tagList = calloc((size_t)hdr->tag_count + 1, sizeof(CodeTaggerData *))))
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      codetagger_unload_tag_file(cnf);
+      return(-1);
+   };
+
+   // references strings in mapped file instead of copying them
+   for(u = 0; u < hdr->tag_count; u++)
+   {
+      if (!(tag = calloc((size_t)1, sizeof(CodeTaggerData))))
+      {
+         fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+         codetagger_unload_tag_file(cnf);
+         return(-1);
+      };
+      cnf->tagList[u] = tag;
+      tag->flags      = CODETAGGER_TAG_MAPPED;
+      tag->name       = &pool[rec[u].name];
+      tag->pattern    = &pool[rec[u].pattern];
+      if (!(tag->contents = malloc(sizeof(char *) * (rec[u].line_count + 1))))
+      {
+         fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+         codetagger_unload_tag_file(cnf);
+         return(-1);
+      };
+      for(x = 0; x < rec[u].line_count; x++)
+         tag->contents[x] = &pool[lines[rec[u].line_first + x]];
+      tag->contents[x] = NULL;
+   };
+   cnf->tagCount = hdr->tag_count;
+
+   return(0);
+}
+
+
+/// releases tags loaded from a compiled tag file and unmaps the file, the
+/// strings of the tags reside in the mapped file
+/// @param[in]  cnf   pointer to config data structure
+void codetagger_unload_tag_file(CodeTagger * cnf)
+{
+   codetagger_free_taglist(cnf, cnf->tagList);
+   cnf->tagList  = NULL;
+   cnf->tagCount = 0;
+   if ((cnf->tag_map))
+      munmap(cnf->tag_map, cnf->tag_map_len);
+   cnf->tag_map     = NULL;
+   cnf->tag_map_len = 0;
+   return;
+}
+
+
 /// generate array of tags from file
 /// @param[in]  cnf   pointer to config data structure
 int codetagger_parse_tag_file(CodeTagger * cnf)
@@ -555,6 +1106,9 @@ int codetagger_parse_tag_file(CodeTagger * cnf)
    memset(errmsg,   0, CODETAGGER_STR_LEN);
    memset(tagName,  0, CODETAGGER_STR_LEN);
 
+   if ((err = codetagger_load_tag_file(cnf)) != 1)
+      return(err);
+
    if (!(data = codetagger_get_file_contents(cnf, cnf->tagFile)))
       return(-1);
 
@@ -627,219 +1181,340 @@ int codetagger_prepare_regex(CodeTagger * cnf)
 }
 
 
-/// retrieves a specific tag from the tag list
-/// @param[in]  cnf         pointer to config data structure
-/// @param[in]  tagName     name of tag to find
-/// @param[in]  fileName    file currently being updated
-/// @param[in]  lineNumber  line number of the current file being updated
-CodeTaggerData * codetagger_retrieve_tag_data(CodeTagger * cnf, const char * tagName,
-   const char * fileName, int lineNumber)
+/// prints lines of file with a unified diff prefix
+/// @param[in]  prefix  character prepended to each line
+/// @param[in]  buff    buffer containing the lines
+/// @param[in]  lines   line index of buffer
+/// @param[in]  count   number of lines in buffer
+/// @param[in]  start   index of first line to print
+/// @param[in]  end     index following the last line to print
+void codetagger_print_diff_lines(char prefix, const char * buff,
+   const size_t * lines, size_t count, size_t start, size_t end)
 {
-   int i;
+   size_t line;
+   size_t len;
 
-   codetagger_debug(cnf);
+   for(line = start; line < end; line++)
+   {
+      len = lines[line+1] - lines[line];
+      if ((len > 0) && (buff[lines[line+1]-1] == '\n'))
+         len--;
+      putchar(prefix);
+      fwrite(&buff[lines[line]], (size_t)1, len, stdout);
+      putchar('\n');
+      if ((line == (count - 1)) && (buff[lines[line+1]-1] != '\n'))
+         printf("\\ No newline at end of file\n");
+   };
 
-   if (!(cnf))
-      return(NULL);
-   if (!(cnf->tagList))
-      return(NULL);
-   if (!(tagName))
-      return(NULL);
-   if (!(fileName))
-      return(NULL);
+   return;
+}
 
-   for(i = 0; cnf->tagList[i]; i++)
-      if (!(strcasecmp(tagName, cnf->tagList[i]->name)))
-         return(cnf->tagList[i]);
 
-   codetagger_verbose(cnf, PROGRAM_NAME ": %s: %i: unknown tag \"%s\"\n", fileName, lineNumber, tagName);
+/// compares two lines from the original and updated file
+/// @param[in]  cnf         pointer to config data structure
+/// @param[in]  orig_lines  line index of original file
+/// @param[in]  orig_line   line of original file
+/// @param[in]  modd_lines  line index of updated file
+/// @param[in]  modd_line   line of updated file
+int codetagger_diff_line_cmp(CodeTagger * cnf, const size_t * orig_lines,
+   size_t orig_line, const size_t * modd_lines, size_t modd_line)
+{
+   size_t len;
 
-   return(NULL);
+   len = orig_lines[orig_line+1] - orig_lines[orig_line];
+   if (len != (modd_lines[modd_line+1] - modd_lines[modd_line]))
+      return(1);
+   return(memcmp(&cnf->buff_orig[orig_lines[orig_line]],
+                 &cnf->buff_modd[modd_lines[modd_line]], len));
 }
 
 
-/// recursively scans directory for files to update
-/// @param[in]  cnf      pointer to config data structure
-/// @param[in]  origin   starting point of the directory recursion
-int codetagger_scan_directory(CodeTagger * cnf, const char * origin)
+/// finds line of buffer containing offset
+/// @param[in]  lines   line index of buffer
+/// @param[in]  count   number of lines in buffer
+/// @param[in]  offset  offset within buffer
+size_t codetagger_diff_line_find(const size_t * lines, size_t count,
+   size_t offset)
 {
-   int             err;
-   DIR           * d;
-   char          * file;
-   char         ** queue;
-   size_t          len_dir;
-   size_t          len_file;
-   size_t          size;
-   size_t          count;
-   struct dirent * dp;
-
-   size  = 0;
-   count = 0;
-   queue = NULL;
-
-   // seeds queue with first file/directory
-   if ((err = codetagger_scan_file(cnf, origin, &count, &queue, &size)))
-      return(err);
+   size_t low;
+   size_t high;
+   size_t mid;
 
-   if (!(cnf->opts & CODETAGGER_OPT_RECURSE))
+   low  = 0;
+   high = count;
+   while((high - low) > 1)
    {
-      if (queue)
-      {
-         free(queue[0]);
-         free(queue);
-      };
-      return(0);
+      mid = (low + high) / 2;
+      if (lines[mid] <= offset)
+         low = mid;
+      else
+         high = mid;
    };
 
-   while(count)
+   return(low);
+}
+
+
+/// prints unified diff of original and updated file
+/// @param[in]  cnf       pointer to config data structure
+/// @param[in]  filename  name of file being processed
+int codetagger_print_diff(CodeTagger * cnf, const char * filename)
+{
+   size_t             u;
+   size_t             x;
+   size_t             count;
+   size_t             orig_count;
+   size_t             modd_count;
+   size_t             hunk_orig;
+   size_t             hunk_modd;
+   size_t             hunk_orig_end;
+   size_t             hunk_modd_end;
+   size_t             line_orig;
+   size_t           * orig_lines;
+   size_t           * modd_lines;
+   CodeTaggerRegion * changes;
+   CodeTaggerRegion * chg;
+
+   codetagger_debug(cnf);
+
+   if (!(orig_lines = codetagger_index_lines(cnf->buff_orig, (size_t)cnf->len_orig, &orig_count)))
+      return(-1);
+   if (!(modd_lines = codetagger_index_lines(cnf->buff_modd, (size_t)cnf->pos_modd, &modd_count)))
+   {
+      free(orig_lines);
+      return(-1);
+   };
+   if (!(changes = malloc(sizeof(CodeTaggerRegion) * (cnf->region_count + 1))))
    {
-      codetagger_verbose(cnf, "scanning \"%s\"\n", queue[count-1]);
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      free(orig_lines);
+      free(modd_lines);
+      return(-1);
+   };
 
-      // opens directory for processing
-      if (!(d = opendir(queue[count-1])))
+   // converts expanded regions into line ranges which differ
+   count = 0;
+   for(u = 0; u < cnf->region_count; u++)
+   {
+      chg = &changes[count];
+      chg->orig_start = codetagger_diff_line_find(orig_lines, orig_count, cnf->regions[u].orig_start);
+      chg->orig_end   = codetagger_diff_line_find(orig_lines, orig_count, cnf->regions[u].orig_end - 1) + 1;
+      chg->modd_start = codetagger_diff_line_find(modd_lines, modd_count, cnf->regions[u].modd_start);
+      chg->modd_end   = codetagger_diff_line_find(modd_lines, modd_count, cnf->regions[u].modd_end - 1) + 1;
+      while ( (chg->orig_start < chg->orig_end) && (chg->modd_start < chg->modd_end) &&
+              (!(codetagger_diff_line_cmp(cnf, orig_lines, chg->orig_start, modd_lines, chg->modd_start))) )
       {
-         codetagger_error(cnf, "%s: %s\n", queue[count-1], strerror(errno));
-         if (!(cnf->opts & CODETAGGER_OPT_CONTINUE))
-            return(1);
+         chg->orig_start++;
+         chg->modd_start++;
       };
+      while ( (chg->orig_start < chg->orig_end) && (chg->modd_start < chg->modd_end) &&
+              (!(codetagger_diff_line_cmp(cnf, orig_lines, chg->orig_end-1, modd_lines, chg->modd_end-1))) )
+      {
+         chg->orig_end--;
+         chg->modd_end--;
+      };
+      if ( (chg->orig_start != chg->orig_end) || (chg->modd_start != chg->modd_end) )
+         count++;
+   };
 
-      len_dir = strlen(queue[count-1]);
+   printf("--- %s\n", filename);
+   printf("+++ %s\n", filename);
 
-      for(dp = readdir(d); dp; dp = readdir(d))
-      {
-         len_file = strlen(dp->d_name);
-         if (!(file = malloc(sizeof(char) * (len_dir + len_file + 2))))
-         {
-            fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
-            return(-1);
-         };
-         sprintf(file, "%s/%s", queue[count-1], dp->d_name);
+   // groups changes separated by less than twice the context into hunks
+   for(u = 0; u < count; u = x)
+   {
+      for(x = u + 1; x < count; x++)
+         if ((changes[x].orig_start - changes[x-1].orig_end) > (2 * CODETAGGER_DIFF_CONTEXT))
+            break;
 
-         if ( (dp->d_name[0] == '.') && (cnf->opts & CODETAGGER_OPT_HIDDEN) )
-         {
-            if ( (dp->d_name[1] != '/') &&
-                 (dp->d_name[1] != '\0') &&
-                 (dp->d_name[1] != '.') )
-            {
-               switch (codetagger_scan_file(cnf, file, &count, &queue, &size))
-               {
-                  case -1:
-                     free(file);
-                     closedir(d);
-                     return(1);
-                  case 0:
-                     free(file);
-                     break;
-                  default:
-                     free(file);
-                     if (!(cnf->opts & CODETAGGER_OPT_CONTINUE))
-                     {
-                        closedir(d);
-                        return(1);
-                     };
-                     break;
-               };
-            };
-         }
-         else if (dp->d_name[0] != '.')
-         {
-            switch (codetagger_scan_file(cnf, file, &count, &queue, &size))
-            {
-               case -1:
-                  free(file);
-                  closedir(d);
-                  return(1);
-               case 0:
-                  free(file);
-                  break;
-               default:
-                  free(file);
-                  if (!(cnf->opts & CODETAGGER_OPT_CONTINUE))
-                  {
-                     closedir(d);
-                     return(1);
-                  };
-                  break;
-            };
-         };
-      };
+      hunk_orig     = (changes[u].orig_start > CODETAGGER_DIFF_CONTEXT) ? changes[u].orig_start - CODETAGGER_DIFF_CONTEXT : 0;
+      hunk_modd     = changes[u].modd_start - (changes[u].orig_start - hunk_orig);
+      hunk_orig_end = changes[x-1].orig_end + CODETAGGER_DIFF_CONTEXT;
+      if (hunk_orig_end > orig_count)
+         hunk_orig_end = orig_count;
+      hunk_modd_end = changes[x-1].modd_end + (hunk_orig_end - changes[x-1].orig_end);
+
+      printf("@@ -%zu,%zu +%zu,%zu @@\n",
+         (hunk_orig_end > hunk_orig) ? hunk_orig + 1 : hunk_orig, hunk_orig_end - hunk_orig,
+         (hunk_modd_end > hunk_modd) ? hunk_modd + 1 : hunk_modd, hunk_modd_end - hunk_modd);
 
-      // closes directory and removes from queue
-      closedir(d);
-      count--;
-      free(queue[count]);
+      line_orig = hunk_orig;
+      for(chg = &changes[u]; chg < &changes[x]; chg++)
+      {
+         codetagger_print_diff_lines(' ', cnf->buff_orig, orig_lines, orig_count, line_orig,       chg->orig_start);
+         codetagger_print_diff_lines('-', cnf->buff_orig, orig_lines, orig_count, chg->orig_start, chg->orig_end);
+         codetagger_print_diff_lines('+', cnf->buff_modd, modd_lines, modd_count, chg->modd_start, chg->modd_end);
+         line_orig = chg->orig_end;
+      };
+      codetagger_print_diff_lines(' ', cnf->buff_orig, orig_lines, orig_count, line_orig, hunk_orig_end);
    };
 
-   free(queue);
+   free(changes);
+   free(orig_lines);
+   free(modd_lines);
 
    return(0);
 }
 
 
-/// scan file to determine wether to attempt and update
-/// @param[in]  cnf      pointer to config data structure
-/// @param[in]  file     file/directory to either update or queue for scanning
-/// @param[in]  countp   pointer to number of directories waiting to be scanned
-/// @param[in]  queuep   pointer to array of directories waiting to be scanned
-/// @param[in]  sizep    pointer to size of array of directories waiting to be scanned
-int codetagger_scan_file(CodeTagger * cnf, const char * file,
-   size_t * countp, char *** queuep, size_t * sizep)
+/// prints processing statistics
+/// @param[in]  cnf   pointer to config data structure
+void codetagger_print_stats(CodeTagger * cnf)
 {
-   int             err;
-   void          * ptr;
-   ssize_t         u;
-   struct stat     sb;
+   CodeTaggerStats * stats;
 
-   if (cnf->opts & CODETAGGER_OPT_LINKS)
-      err = stat(file, &sb);
-   else
-      err = lstat(file, &sb);
-   if (err == -1)
+   stats = &cnf->stats;
+
+   fprintf(stderr, "files scanned:     %zu\n",   stats->files_scanned);
+   fprintf(stderr, "files skipped:     %zu\n",   stats->files_skipped);
+   fprintf(stderr, "files updated:     %zu\n",   stats->files_changed);
+   fprintf(stderr, "tags expanded:     %zu\n",   stats->tags_expanded);
+   fprintf(stderr, "bytes written:     %zu\n",   stats->bytes_written);
+   fprintf(stderr, "time walking:      %.6fs\n", stats->time_walk);
+   fprintf(stderr, "time reading:      %.6fs\n", stats->time_read);
+   fprintf(stderr, "time matching:     %.6fs\n", stats->time_match);
+   fprintf(stderr, "time writing:      %.6fs\n", stats->time_write);
+
+   return;
+}
+
+
+/// records region of file replaced by tag expansion
+/// @param[in]  cnf         pointer to config data structure
+/// @param[in]  orig_start  offset of region in original file
+/// @param[in]  orig_end    offset of end of region in original file
+/// @param[in]  modd_start  offset of region in updated file
+int codetagger_record_region(CodeTagger * cnf, size_t orig_start,
+   size_t orig_end, size_t modd_start)
+{
+   void             * ptr;
+   CodeTaggerRegion * region;
+
+   if (cnf->region_count >= cnf->region_size)
    {
-      codetagger_error(cnf, "%s: %s\n", file, strerror(errno));
-      return(1);
+      if (!(ptr = realloc(cnf->regions, sizeof(CodeTaggerRegion) * (cnf->region_size + 32))))
+      {
+         fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+         return(-1);
+      };
+      cnf->regions      = ptr;
+      cnf->region_size += 32;
    };
-   switch(sb.st_mode & (S_IFDIR|S_IFREG|S_IFLNK))
-   {
-      case S_IFDIR:
-         // adjust size of array
-         if (*countp >= *sizep)
-         {
-            *sizep += 20;
-            if (!(ptr = realloc(*queuep, sizeof(char *) * (*sizep))))
-            {
-               fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
-               return(-1);
-            };
-            *queuep = ptr;
-         };
 
-         // copy path name
-         if (!(ptr = strdup(file)))
-         {
-            fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
-            return(-1);
-         };
+   region = &cnf->regions[cnf->region_count];
+   region->orig_start = orig_start;
+   region->orig_end   = orig_end;
+   region->modd_start = modd_start;
+   region->modd_end   = (size_t)cnf->pos_modd;
+   cnf->region_count++;
 
-         // insert path name at head of array
-         for(u = (*countp); u > 0; u--)
-            (*queuep)[u] = (*queuep)[u-1];
-         (*queuep)[0] = ptr;
-         (*countp)++;
-         break;
+   return(0);
+}
 
-      case S_IFLNK:  // ignore symbolic links
-         break;
 
-      case S_IFREG:
-         return(codetagger_update_file(cnf, file, &sb));
+/// retrieves a specific tag from the tag list
+/// @param[in]  cnf         pointer to config data structure
+/// @param[in]  tagName     name of tag to find
+/// @param[in]  fileName    file currently being updated
+/// @param[in]  lineNumber  line number of the current file being updated
+CodeTaggerData * codetagger_retrieve_tag_data(CodeTagger * cnf, const char * tagName,
+   const char * fileName, int lineNumber)
+{
+   int i;
+
+   codetagger_debug(cnf);
+
+   if (!(cnf))
+      return(NULL);
+   if (!(cnf->tagList))
+      return(NULL);
+   if (!(tagName))
+      return(NULL);
+   if (!(fileName))
+      return(NULL);
+
+   for(i = 0; cnf->tagList[i]; i++)
+      if (!(strcasecmp(tagName, cnf->tagList[i]->name)))
+         return(cnf->tagList[i]);
+
+   codetagger_verbose(cnf, PROGRAM_NAME ": %s: %i: unknown tag \"%s\"\n", fileName, lineNumber, tagName);
+
+   return(NULL);
+}
+
+
+/// recursively scans directory for files to update
+/// @param[in]  cnf      pointer to config data structure
+/// @param[in]  origin   starting point of the directory recursion
+int codetagger_scan_directory(CodeTagger * cnf, const char * origin)
+{
+   WalkConfig      cfg;
+
+   memset(&cfg, 0, sizeof(cfg));
+   cfg.opts = WALK_OPT_STAT;
+   cfg.jobs = 1;
+   cfg.data = cnf;
+   cfg.func = codetagger_scan_entry;
+   if ((cnf->opts & CODETAGGER_OPT_CONTINUE))
+      cfg.opts |= WALK_OPT_CONTINUE;
+   if ((cnf->opts & CODETAGGER_OPT_HIDDEN))
+      cfg.opts |= WALK_OPT_HIDDEN;
+   if ((cnf->opts & CODETAGGER_OPT_LINKS))
+      cfg.opts |= WALK_OPT_LINKS;
+   if ((cnf->opts & CODETAGGER_OPT_RECURSE))
+      cfg.opts |= WALK_OPT_RECURSE;
+
+   return(walk_tree(origin, &cfg));
+}
+
+
+/// scan entry to determine wether to attempt and update
+/// @param[in]  entry    file or directory found while scanning
+/// @param[in]  data     pointer to config data structure
+int codetagger_scan_entry(const WalkEntry * entry, void * data)
+{
+   int             err;
+   CodeTagger    * cnf;
+   struct stat     sb;
+
+   cnf = data;
+
+   switch(entry->type)
+   {
+      case WALK_DIR:
+         codetagger_verbose(cnf, "scanning \"%s\"\n", entry->path);
+         return(0);
+
+      case WALK_LINK:  // ignore symbolic links
+         cnf->stats.files_skipped++;
+         return(0);
+
+      case WALK_FILE:
+         sb = *entry->sb;
+         if ( ((cnf->opts & CODETAGGER_OPT_STREAM)) || ((size_t)sb.st_size > CODETAGGER_MAX_BUFFER) )
+            err = codetagger_stream_file(cnf, entry->path);
+         else
+            err = codetagger_update_file(cnf, entry->path, &sb);
+         if ((err))
+            cnf->stats.files_skipped++;
+         else
+            cnf->stats.files_scanned++;
+         return(err);
+
+      case WALK_OTHER:
+         cnf->stats.files_skipped++;
+         codetagger_error(cnf, "%s: unknown file type\n", entry->path);
+         return(1);
 
       default:
-         codetagger_error(cnf, "%s: unknown file type\n", file);
+         if (entry->mode != S_IFDIR)
+            cnf->stats.files_skipped++;
+         if (entry->err == ENOMEM)
+            fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+         else
+            codetagger_error(cnf, "%s: %s\n", entry->path, strerror(entry->err));
          return(1);
    };
-
-   return(0);
 }
 
 
@@ -853,22 +1528,28 @@ int codetagger_update_file(CodeTagger * cnf, const char * filename,
    int          err;
    long long    pos;
    int          changed;
+   ssize_t      written;
    long long    len_margin;
    long long    len_stripped;
    long long    len_tagname;
    char         margin[CODETAGGER_STR_LEN];
    char         stripped[CODETAGGER_STR_LEN];
    char         tagname[CODETAGGER_STR_LEN];
-   char       * bol;
+   size_t       region_orig;
+   size_t       region_modd;
+   int          bol;
    regmatch_t   match[5];
    CodeTaggerData * tag;
    struct stat sb;
+   struct timespec ts;
 
    codetagger_debug(cnf);
    codetagger_debug_ext(cnf, filename);
    codetagger_verbose(cnf, "processing \"%s\"\n", filename);
 
-   changed = 0;
+   changed           = 0;
+   cnf->region_count = 0;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
 
    if ((err = codetagger_buffer_resize(cnf, (size_t)sbp->st_size, filename)))
       return(err);
@@ -892,9 +1573,10 @@ int codetagger_update_file(CodeTagger * cnf, const char * filename,
    };
    cnf->buff_orig[sbp->st_size] = '\0';
    close(fd);
+   cnf->stats.time_read += codetagger_elapsed(&ts);
 
    cnf->pos_modd = 0;
-   bol           = &cnf->buff_orig[0];
+   bol           = 0;
 
    for(cnf->pos_orig = 0; cnf->pos_orig < cnf->len_orig; cnf->pos_orig++)
    {
@@ -908,20 +1590,20 @@ int codetagger_update_file(CodeTagger * cnf, const char * filename,
          continue;
 
       cnf->buff_orig[cnf->pos_orig] = '\0';
-      err = regexec(&cnf->generic_tag, bol, (size_t)5, match, 0);
+      err = regexec(&cnf->generic_tag, &cnf->buff_orig[bol], (size_t)5, match, 0);
       cnf->buff_orig[cnf->pos_orig] = '\n';
 
       if (err != 0)
       {
-         bol = &cnf->buff_orig[cnf->pos_orig+1];
+         bol = cnf->pos_orig + 1;
          continue;
       };
 
       len_margin  = match[1].rm_eo - match[1].rm_so;
       len_tagname = match[2].rm_eo - match[2].rm_so;
 
-      memcpy(margin,  &bol[(int)match[1].rm_so], (size_t)len_margin);
-      memcpy(tagname, &bol[(int)match[2].rm_so], (size_t)len_tagname);
+      memcpy(margin,  &cnf->buff_orig[bol + (int)match[1].rm_so], (size_t)len_margin);
+      memcpy(tagname, &cnf->buff_orig[bol + (int)match[2].rm_so], (size_t)len_tagname);
 
       margin[len_margin]   = '\0';
       tagname[len_tagname] = '\0';
@@ -933,19 +1615,23 @@ int codetagger_update_file(CodeTagger * cnf, const char * filename,
             len_stripped = pos;
       stripped[len_stripped] = '\0';
 
-      bol = &cnf->buff_orig[cnf->pos_orig+1];
+      bol = cnf->pos_orig + 1;
 
       if (!(tag = codetagger_retrieve_tag_data(cnf, tagname, filename, cnf->pos_orig)))
          continue;
 
       // fast forwards to end tag in original file
+      if ((err = codetagger_compile_tag(cnf, tag)))
+         return(err);
       if ((regexec(&tag->regex, &cnf->buff_orig[cnf->pos_orig+1], (size_t)5, match, 0)))
       {
          codetagger_error(cnf, "%s: missing \"%sEND\" tag\n", filename, tagname);
          return(1);
       };
+      region_orig    = (size_t)cnf->pos_orig + 1;
+      region_modd    = (size_t)cnf->pos_modd;
       cnf->pos_orig += match[1].rm_eo;
-      bol = &cnf->buff_orig[cnf->pos_orig];
+      bol = cnf->pos_orig + 1;
 
       for(pos = 0; tag->contents[pos]; pos++)
       {
@@ -974,7 +1660,13 @@ int codetagger_update_file(CodeTagger * cnf, const char * filename,
          return(err);
       if ((err = codetagger_buffer_write(cnf, "END", (size_t)3, filename)))
          return(err);
+
+      cnf->stats.tags_expanded++;
+      if ((cnf->opts & CODETAGGER_OPT_TEST))
+         if ((err = codetagger_record_region(cnf, region_orig, (size_t)cnf->pos_orig + 1, region_modd)))
+            return(err);
    };
+   cnf->stats.time_match += codetagger_elapsed(&ts);
 
    if (cnf->pos_modd != cnf->pos_orig)
       changed = 1;
@@ -985,6 +1677,16 @@ int codetagger_update_file(CodeTagger * cnf, const char * filename,
    if (!(changed))
       return(0);
 
+   cnf->stats.files_changed++;
+
+   // displays changes instead of updating file
+   if ((cnf->opts & CODETAGGER_OPT_TEST))
+   {
+      err = codetagger_print_diff(cnf, filename);
+      cnf->stats.time_write += codetagger_elapsed(&ts);
+      return(err);
+   };
+
    if (!(cnf->opts & CODETAGGER_OPT_QUIET))
       printf("updating \"%s\"\n", filename);
 
@@ -994,13 +1696,481 @@ int codetagger_update_file(CodeTagger * cnf, const char * filename,
       close(fd);
       return(1);
    };
-   if (write(fd, cnf->buff_modd, (size_t)cnf->pos_modd) == -1)
+   if ((written = write(fd, cnf->buff_modd, (size_t)cnf->pos_modd)) == -1)
    {
       codetagger_error(cnf, "%s: %s\n", filename, strerror(errno));
       close(fd);
       return(1);
    };
    close(fd);
+   cnf->stats.bytes_written += (size_t)written;
+   cnf->stats.time_write += codetagger_elapsed(&ts);
+
+   return(0);
+}
+
+
+/// appends data to expansion of current tag
+/// @param[in]  cnf   pointer to config data structure
+/// @param[in]  st    state of streamed file
+/// @param[in]  src   source buffer to copy
+/// @param[in]  len   length of data
+int codetagger_stream_append(CodeTagger * cnf, CodeTaggerStream * st,
+   const char * src, size_t len)
+{
+   void * ptr;
+
+   if ((st->exp_len + len) > st->exp_size)
+   {
+      if (!(ptr = realloc(st->exp, st->exp_len + len + 1024)))
+      {
+         codetagger_error(NULL, "out of virtual memory\n");
+         return(-1);
+      };
+      st->exp      = ptr;
+      st->exp_size = st->exp_len + len + 1024;
+   };
+
+   memcpy(&st->exp[st->exp_len], src, len);
+   st->exp_len += len;
+
+   codetagger_debug_ext(cnf, "%zu", st->exp_len);
+
+   return(0);
+}
+
+
+/// copies updated temporary file into original file, which keeps the inode,
+/// links, owner, and mode of the original file
+/// @param[in]  cnf       pointer to config data structure
+/// @param[in]  tmpfile   temporary file containing updated contents
+/// @param[in]  filename  original file
+int codetagger_stream_copy(CodeTagger * cnf, const char * tmpfile,
+   const char * filename)
+{
+   int                fd;
+   int                tmpfd;
+   ssize_t            len;
+
+   codetagger_debug(cnf);
+
+   if ((tmpfd = open(tmpfile, O_RDONLY)) == -1)
+   {
+      codetagger_error(cnf, "%s: %s\n", tmpfile, strerror(errno));
+      return(1);
+   };
+   if ((fd = open(filename, O_WRONLY|O_TRUNC)) == -1)
+   {
+      codetagger_error(cnf, "%s: %s\n", filename, strerror(errno));
+      close(tmpfd);
+      return(1);
+   };
+
+   while ((len = read(tmpfd, cnf->buff_orig, CODETAGGER_STREAM_CHUNK)) > 0)
+   {
+      if ((codetagger_write_full(fd, cnf->buff_orig, (size_t)len)))
+      {
+         codetagger_error(cnf, "%s: %s, updated contents remain in \"%s\"\n", filename, strerror(errno), tmpfile);
+         close(tmpfd);
+         close(fd);
+         return(1);
+      };
+   };
+   if (len == -1)
+      codetagger_error(cnf, "%s: %s, updated contents remain in \"%s\"\n", tmpfile, strerror(errno), tmpfile);
+   close(tmpfd);
+   if ((close(fd) == -1) && (len != -1))
+   {
+      codetagger_error(cnf, "%s: %s, updated contents remain in \"%s\"\n", filename, strerror(errno), tmpfile);
+      len = -1;
+   };
+
+   return((len == -1) ? 1 : 0);
+}
+
+
+/// updates file by processing it in fixed size chunks
+/// @param[in]  cnf       pointer to config data structure
+/// @param[in]  filename  name of file to process
+int codetagger_stream_file(CodeTagger * cnf, const char * filename)
+{
+   int                fd;
+   int                err;
+   int                eof;
+   int                copy;
+   size_t             len;
+   size_t             start;
+   ssize_t            rc;
+   char             * nl;
+   char             * tmpfile;
+   struct stat        sb;
+   struct stat        lsb;
+   CodeTaggerStream   st;
+
+   codetagger_debug(cnf);
+   codetagger_debug_ext(cnf, filename);
+   codetagger_verbose(cnf, "streaming \"%s\"\n", filename);
+
+   memset(&st, 0, sizeof(st));
+   st.fd       = -1;
+   st.filename = filename;
+   tmpfile     = NULL;
+   clock_gettime(CLOCK_MONOTONIC, &st.ts);
+
+   if ((err = codetagger_buffer_resize(cnf, CODETAGGER_STREAM_CHUNK, filename)))
+      return(err);
+   cnf->pos_modd = 0;
+
+   if ((fd = open(filename, O_RDONLY)) == -1)
+   {
+      codetagger_error(cnf, "%s: %s\n", filename, strerror(errno));
+      return(1);
+   };
+   if ((fstat(fd, &sb)) == -1)
+   {
+      codetagger_error(cnf, "%s: %s\n", filename, strerror(errno));
+      close(fd);
+      return(1);
+   };
+
+   // renaming the temporary file would replace the inode of the original,
+   // so the result is copied back into files with several links, into the
+   // targets of symbolic links, and into files whose owner cannot be kept
+   copy = (sb.st_nlink > 1) ? 1 : 0;
+   if ( (!(copy)) && ((lstat(filename, &lsb) == -1) || (S_ISLNK(lsb.st_mode))) )
+      copy = 1;
+
+   // writes output to a temporary file in the same directory as the original
+   if (!(cnf->opts & CODETAGGER_OPT_TEST))
+   {
+      if (!(tmpfile = malloc(strlen(filename) + 8)))
+      {
+         codetagger_error(NULL, "out of virtual memory\n");
+         close(fd);
+         return(-1);
+      };
+      sprintf(tmpfile, "%s.XXXXXX", filename);
+      if ((st.fd = mkstemp(tmpfile)) == -1)
+      {
+         codetagger_error(cnf, "%s: %s\n", tmpfile, strerror(errno));
+         free(tmpfile);
+         close(fd);
+         return(1);
+      };
+      if ( (!(copy)) && ((fchown(st.fd, sb.st_uid, sb.st_gid) == -1) || (fchmod(st.fd, sb.st_mode & 07777) == -1)) )
+         copy = 1;
+   };
+
+   len   = 0;
+   start = 0;
+   eof   = 0;
+   err   = 0;
+   while ((!(eof)) && (!(err)))
+   {
+      // carries partial line over to the beginning of the buffer
+      if (start > 0)
+      {
+         memmove(cnf->buff_orig, &cnf->buff_orig[start], len - start);
+         len  -= start;
+         start = 0;
+      };
+
+      cnf->stats.time_match += codetagger_elapsed(&st.ts);
+      if ((rc = read(fd, &cnf->buff_orig[len], CODETAGGER_STREAM_CHUNK - len)) == -1)
+      {
+         codetagger_error(cnf, "%s: %s\n", filename, strerror(errno));
+         err = 1;
+         break;
+      };
+      cnf->stats.time_read += codetagger_elapsed(&st.ts);
+      eof  = (rc == 0) ? 1 : 0;
+      len += (size_t)rc;
+
+      while ((!(err)) && ((nl = memchr(&cnf->buff_orig[start], '\n', len - start))))
+      {
+         err = codetagger_stream_line(cnf, &st, &cnf->buff_orig[start], (size_t)(nl - &cnf->buff_orig[start]) + 1, 1);
+         start = (size_t)(nl - cnf->buff_orig) + 1;
+      };
+
+      // passes through remainder of file or of a line which does not fit in the buffer
+      if ((!(err)) && (start < len) && ((eof) || ((start == 0) && (len == CODETAGGER_STREAM_CHUNK))))
+      {
+         err   = codetagger_stream_line(cnf, &st, &cnf->buff_orig[start], len - start, 0);
+         start = len;
+         st.overlong = 1;
+      };
+   };
+   close(fd);
+
+   if ((!(err)) && ((st.tag)))
+   {
+      codetagger_error(cnf, "%s: missing \"%sEND\" tag\n", filename, st.tag->name);
+      err = 1;
+   };
+   if (!(err))
+      err = codetagger_stream_flush(cnf, &st);
+   if ((st.fd != -1) && (close(st.fd) == -1) && (!(err)))
+   {
+      codetagger_error(cnf, "%s: %s\n", st.filename, strerror(errno));
+      err = 1;
+   };
+   free(st.exp);
+
+   if ((err) || (!(st.changed)) || ((cnf->opts & CODETAGGER_OPT_TEST)))
+   {
+      if ((tmpfile))
+      {
+         unlink(tmpfile);
+         free(tmpfile);
+      };
+      if ((!(err)) && ((st.changed)))
+      {
+         cnf->stats.files_changed++;
+         if (!(cnf->opts & CODETAGGER_OPT_QUIET))
+            printf("would update \"%s\"\n", filename);
+      };
+      cnf->stats.time_write += codetagger_elapsed(&st.ts);
+      return(err);
+   };
+
+   cnf->stats.files_changed++;
+   if (!(cnf->opts & CODETAGGER_OPT_QUIET))
+      printf("updating \"%s\"\n", filename);
+
+   if ((copy))
+   {
+      // keeps temporary file if the original was partially overwritten
+      if ((err = codetagger_stream_copy(cnf, tmpfile, filename)) == 0)
+         unlink(tmpfile);
+      free(tmpfile);
+      if ((err))
+         return(err);
+   }
+   else if ((rename(tmpfile, filename)))
+   {
+      codetagger_error(cnf, "%s: %s\n", filename, strerror(errno));
+      unlink(tmpfile);
+      free(tmpfile);
+      return(1);
+   }
+   else
+   {
+      free(tmpfile);
+   };
+   cnf->stats.bytes_written += st.written;
+   cnf->stats.time_write += codetagger_elapsed(&st.ts);
+
+   return(0);
+}
+
+
+/// writes buffered output to temporary file
+/// @param[in]  cnf   pointer to config data structure
+/// @param[in]  st    state of streamed file
+int codetagger_stream_flush(CodeTagger * cnf, CodeTaggerStream * st)
+{
+   if (!(cnf->pos_modd))
+      return(0);
+
+   st->written += (size_t)cnf->pos_modd;
+
+   if (st->fd != -1)
+   {
+      cnf->stats.time_match += codetagger_elapsed(&st->ts);
+      if ((codetagger_write_full(st->fd, cnf->buff_modd, (size_t)cnf->pos_modd)))
+      {
+         codetagger_error(cnf, "%s: %s\n", st->filename, strerror(errno));
+         return(1);
+      };
+      cnf->stats.time_write += codetagger_elapsed(&st->ts);
+   };
+
+   cnf->pos_modd = 0;
+
+   return(0);
+}
+
+
+/// processes a single line of a streamed file
+/// @param[in]  cnf      pointer to config data structure
+/// @param[in]  st       state of streamed file
+/// @param[in]  line     line to process, buffer must have room for a terminating NUL
+/// @param[in]  len      length of line
+/// @param[in]  newline  line is terminated by a newline
+int codetagger_stream_line(CodeTagger * cnf, CodeTaggerStream * st,
+   char * line, size_t len, int newline)
+{
+   int          err;
+   char         saved;
+   long long    pos;
+   long long    len_margin;
+   long long    len_stripped;
+   long long    len_tagname;
+   char         margin[CODETAGGER_STR_LEN];
+   char         stripped[CODETAGGER_STR_LEN];
+   char         tagname[CODETAGGER_STR_LEN];
+   regmatch_t   match[5];
+
+   while (len > 0)
+   {
+      // terminates line for regexec()
+      saved = line[len - ((newline) ? 1 : 0)];
+      line[len - ((newline) ? 1 : 0)] = '\0';
+
+      // compares body of tag in original file against the expansion
+      if ((st->tag))
+      {
+         st->overlong = ((newline)) ? 0 : st->overlong;
+         err = regexec(&st->tag->regex, line, (size_t)5, match, 0);
+         line[len - ((newline) ? 1 : 0)] = saved;
+         pos = (err) ? (long long)len : (long long)match[1].rm_eo;
+         if ( (!(st->changed)) &&
+              ( ((st->exp_pos + (size_t)pos) > st->exp_len) ||
+                ((memcmp(&st->exp[st->exp_pos], line, (size_t)pos))) ) )
+            st->changed = 1;
+         st->exp_pos += (size_t)pos;
+         st->offset  += (size_t)pos;
+         if ((err))
+            return(0);
+
+         // writes expansion and processes remainder of line
+         if (st->exp_pos != st->exp_len)
+            st->changed = 1;
+         if ((err = codetagger_stream_write(cnf, st, st->exp, st->exp_len)))
+            return(err);
+         cnf->stats.tags_expanded++;
+         st->tag  = NULL;
+         line    += pos;
+         len     -= (size_t)pos;
+         continue;
+      };
+
+      // copies line to output
+      line[len - ((newline) ? 1 : 0)] = saved;
+      if ((err = codetagger_stream_write(cnf, st, line, len)))
+         return(err);
+      st->offset += len;
+      if ((!(newline)) || ((st->overlong)))
+      {
+         st->overlong = (newline) ? 0 : st->overlong;
+         return(0);
+      };
+
+      // searches for start tag
+      line[len-1] = '\0';
+      err = regexec(&cnf->generic_tag, line, (size_t)5, match, 0);
+      line[len-1] = '\n';
+      if (err != 0)
+         return(0);
+
+      len_margin  = match[1].rm_eo - match[1].rm_so;
+      len_tagname = match[2].rm_eo - match[2].rm_so;
+      if ((len_margin >= (long long)CODETAGGER_STR_LEN) || (len_tagname >= (long long)CODETAGGER_STR_LEN))
+         return(0);
+
+      memcpy(margin,  &line[(int)match[1].rm_so], (size_t)len_margin);
+      memcpy(tagname, &line[(int)match[2].rm_so], (size_t)len_tagname);
+
+      margin[len_margin]   = '\0';
+      tagname[len_tagname] = '\0';
+
+      len_stripped = 0;
+      memcpy(stripped, margin, (size_t)len_margin);
+      for(pos = len_margin; ((pos > 0) && (!(len_stripped))); pos--)
+         if ((stripped[pos-1] != ' ') && (stripped[pos-1] != '\t'))
+            len_stripped = pos;
+      stripped[len_stripped] = '\0';
+
+      if (!(st->tag = codetagger_retrieve_tag_data(cnf, tagname, st->filename, (int)st->offset)))
+         return(0);
+      if ((err = codetagger_compile_tag(cnf, st->tag)))
+         return(err);
+
+      // builds expansion of tag which replaces the body of the tag
+      st->exp_len = 0;
+      st->exp_pos = 0;
+      for(pos = 0; st->tag->contents[pos]; pos++)
+      {
+         if (!(st->tag->contents[pos][0]))
+            err = codetagger_stream_append(cnf, st, stripped, (size_t)len_stripped);
+         else
+            err = codetagger_stream_append(cnf, st, margin, (size_t)len_margin);
+         if (!(err))
+            err = codetagger_stream_append(cnf, st, st->tag->contents[pos], strlen(st->tag->contents[pos]));
+         if (!(err))
+            err = codetagger_stream_append(cnf, st, "\n", (size_t)1);
+         if ((err))
+            return(err);
+      };
+      if ((err = codetagger_stream_append(cnf, st, margin, (size_t)len_margin)))
+         return(err);
+      if ((err = codetagger_stream_append(cnf, st, cnf->leftTagString, strlen(cnf->leftTagString))))
+         return(err);
+      if ((err = codetagger_stream_append(cnf, st, tagname, (size_t)len_tagname)))
+         return(err);
+      if ((err = codetagger_stream_append(cnf, st, "END", (size_t)3)))
+         return(err);
+
+      return(0);
+   };
+
+   return(0);
+}
+
+
+/// appends data to buffered output of streamed file
+/// @param[in]  cnf   pointer to config data structure
+/// @param[in]  st    state of streamed file
+/// @param[in]  src   source buffer to copy
+/// @param[in]  len   length of data
+int codetagger_stream_write(CodeTagger * cnf, CodeTaggerStream * st,
+   const char * src, size_t len)
+{
+   int    err;
+   size_t size;
+
+   while (len > 0)
+   {
+      if ((size_t)cnf->pos_modd >= CODETAGGER_STREAM_CHUNK)
+         if ((err = codetagger_stream_flush(cnf, st)))
+            return(err);
+      size = CODETAGGER_STREAM_CHUNK - (size_t)cnf->pos_modd;
+      size = (size < len) ? size : len;
+      memcpy(&cnf->buff_modd[cnf->pos_modd], src, size);
+      cnf->pos_modd += (int)size;
+      src           += size;
+      len           -= size;
+   };
+
+   return(0);
+}
+
+
+/// writes entire buffer to file descriptor, retrying short and interrupted
+/// writes so that a full disk is reported instead of truncating the file
+/// @param[in]  fd    file descriptor
+/// @param[in]  buff  data to write
+/// @param[in]  len   length of data
+int codetagger_write_full(int fd, const char * buff, size_t len)
+{
+   ssize_t rc;
+
+   while (len > 0)
+   {
+      if ((rc = write(fd, buff, len)) == -1)
+      {
+         if (errno == EINTR)
+            continue;
+         return(-1);
+      };
+      if (rc == 0)
+      {
+         errno = ENOSPC;
+         return(-1);
+      };
+      buff += rc;
+      len  -= (size_t)rc;
+   };
 
    return(0);
 }
@@ -1011,6 +2181,7 @@ void codetagger_usage(void)
 {
    printf("Usage: %s [OPTIONS] files\n", PROGRAM_NAME);
    printf("  -a                        include hidden files\n");
+   printf("  -C, --compile=file        write compiled tag file and exit\n");
    printf("  -c                        continue on error\n");
    printf("  -d                        enter debug mode\n");
    printf("  -f                        force writes\n");
@@ -1021,7 +2192,9 @@ void codetagger_usage(void)
    printf("  -q, --quiet, --silent     do not print messages\n");
    printf("  -r str                    right enclosing string for tags\n");
    printf("  -R                        recursively follow directories\n");
-   printf("  -t, --test                show what would be done\n");
+   printf("  -S, --stream              process files in fixed size chunks\n");
+   printf("  -s, --stats               print statistics and timings\n");
+   printf("  -t, --test                print differences instead of updating files\n");
    printf("  -v, --verbose             print verbose messages\n");
    printf("  -V, --version             print version number and exit\n");
    printf("\n");
@@ -1130,12 +2303,7 @@ int codetagger_process_tag(CodeTagger * cnf, char * tagName, char ** data, size_
    };
 
    // compiles regular expression
-   codetagger_escape_string(cnf, regstr, cnf->leftTagString,  CODETAGGER_STR_LEN);
-   strncat(regstr,       "(",                 CODETAGGER_STR_LEN);
-   strncat(regstr,       tagName,             CODETAGGER_STR_LEN);
-   strncat(regstr,       "END",               CODETAGGER_STR_LEN);
-   strncat(regstr,       ")",                 CODETAGGER_STR_LEN);
-   codetagger_escape_string(cnf, regstr, cnf->rightTagString, CODETAGGER_STR_LEN);
+   codetagger_build_tag_regex(cnf, regstr, tagName);
    if ((err = regcomp(&tag->regex, regstr, REG_EXTENDED|REG_ICASE)))
    {
       regerror(err, &tag->regex, errmsg, CODETAGGER_STR_LEN-1);
@@ -1143,6 +2311,7 @@ int codetagger_process_tag(CodeTagger * cnf, char * tagName, char ** data, size_
       codetagger_free_tag(cnf, tag);
       return(-1);
    };
+   tag->flags |= CODETAGGER_TAG_COMPILED;
 
    // loops through file
    err = 1;
@@ -1192,14 +2361,18 @@ int main(int argc, char * argv[])
    int           i;
    int           opt_index;
    CodeTagger        cnf;
+   struct timespec   ts;
 
-   static char   short_opt[] = "acdfhi:Ll:qRr:tvV";
+   static char   short_opt[] = "aC:cdfhi:Ll:qRr:SstvV";
    static struct option long_opt[] =
    {
+      {"compile",       required_argument, 0, 'C'},
       {"continue",      no_argument, 0, 'c'},
       {"help",          no_argument, 0, 'h'},
       {"silent",        no_argument, 0, 'q'},
       {"quiet",         no_argument, 0, 'q'},
+      {"stats",         no_argument, 0, 's'},
+      {"stream",        no_argument, 0, 'S'},
       {"test",          no_argument, 0, 't'},
       {"verbose",       no_argument, 0, 'v'},
       {"version",       no_argument, 0, 'V'},
@@ -1228,6 +2401,9 @@ int main(int argc, char * argv[])
          case 'a':
             cnf.opts |= CODETAGGER_OPT_HIDDEN;
             break;
+         case 'C':
+            cnf.compileFile = optarg;
+            break;
          case 'c':
             cnf.opts |= CODETAGGER_OPT_CONTINUE;
             break;
@@ -1259,6 +2435,12 @@ int main(int argc, char * argv[])
          case 'r':
             cnf.rightTagString = optarg;
             break;
+         case 'S':
+            cnf.opts |= CODETAGGER_OPT_STREAM;
+            break;
+         case 's':
+            cnf.opts |= CODETAGGER_OPT_STATS;
+            break;
          case 't':
             cnf.opts |= CODETAGGER_OPT_TEST;
             break;
@@ -1280,7 +2462,7 @@ int main(int argc, char * argv[])
    };
 
    // verifies arguments were passed on the command line
-   if ((optind == argc) || (optind == 1))
+   if ((optind == 1) || ((optind == argc) && (!(cnf.compileFile))))
    {
       codetagger_usage();
       return(1);
@@ -1300,6 +2482,8 @@ int main(int argc, char * argv[])
    codetagger_debug_ext(&cnf, "Follow Symlinks:   %s", (cnf.opts & CODETAGGER_OPT_LINKS)    ? "yes" : "no");
    codetagger_debug_ext(&cnf, "Quiet Mode:        %s", (cnf.opts & CODETAGGER_OPT_QUIET)    ? "yes" : "no");
    codetagger_debug_ext(&cnf, "Recurse Mode:      %s", (cnf.opts & CODETAGGER_OPT_RECURSE)  ? "yes" : "no");
+   codetagger_debug_ext(&cnf, "Statistics:        %s", (cnf.opts & CODETAGGER_OPT_STATS)    ? "yes" : "no");
+   codetagger_debug_ext(&cnf, "Streaming Mode:    %s", (cnf.opts & CODETAGGER_OPT_STREAM)   ? "yes" : "no");
    codetagger_debug_ext(&cnf, "Test Mode:         %s", (cnf.opts & CODETAGGER_OPT_TEST)     ? "yes" : "no");
    codetagger_debug_ext(&cnf, "Verbose Mode:      %s", (cnf.opts & CODETAGGER_OPT_VERBOSE)  ? "yes" : "no");
    codetagger_debug_ext(&cnf, "Left Bracket:      %s", cnf.leftTagString);
@@ -1308,6 +2492,13 @@ int main(int argc, char * argv[])
    if ((codetagger_parse_tag_file(&cnf)))
       return(0);
 
+   if ((cnf.compileFile))
+   {
+      i = codetagger_compile_tag_file(&cnf);
+      codetagger_free_taglist(&cnf, cnf.tagList);
+      return((i) ? 1 : 0);
+   };
+
    if (codetagger_prepare_regex(&cnf))
       return(1);
 
@@ -1318,6 +2509,7 @@ int main(int argc, char * argv[])
    };
 
    // loops through files to be tagged
+   clock_gettime(CLOCK_MONOTONIC, &ts);
    for(i = optind; i < argc; i++)
       switch (codetagger_scan_directory(&cnf, argv[i]))
       {
@@ -1329,7 +2521,16 @@ int main(int argc, char * argv[])
             break;
       };
 
+   // time not spent processing individual files was spent walking directories
+   cnf.stats.time_walk  = codetagger_elapsed(&ts);
+   cnf.stats.time_walk -= cnf.stats.time_read + cnf.stats.time_match + cnf.stats.time_write;
+   if ((cnf.opts & CODETAGGER_OPT_STATS))
+      codetagger_print_stats(&cnf);
+
    codetagger_free_taglist(&cnf, cnf.tagList);
+   free(cnf.regions);
+   if ((cnf.tag_map))
+      munmap(cnf.tag_map, cnf.tag_map_len);
 
    return(0);
 }
@@ -1,7 +1,8 @@
-codetagger: Makefile codetagger.c codetagger.mak
+codetagger: Makefile codetagger.c walk.c walk.h codetagger.mak
 	$(LIBTOOL) --mode=compile --tag=CC $(CC) $(CFLAGS) -c codetagger.c
-	$(LIBTOOL) --mode=link    --tag=CC $(CC) $(CFLAGS) -o codetagger codetagger.lo
+	$(LIBTOOL) --mode=compile --tag=CC $(CC) $(CFLAGS) -c walk.c
+	$(LIBTOOL) --mode=link    --tag=CC $(CC) $(CFLAGS) -o codetagger codetagger.lo walk.lo -lpthread
 
 codetagger-clean:
-	$(LIBTOOL) --mode=clean rm -f codetagger.lo codetagger
+	$(LIBTOOL) --mode=clean rm -f codetagger.lo walk.lo codetagger
 
@@ -72,6 +72,8 @@
 #include <strings.h>
 #include <fcntl.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include <sys/uio.h>
 #include <unistd.h>
 #include <stdarg.h>
@@ -79,9 +81,9 @@
 #include <regex.h>
 #include <sys/socket.h>
 #include <signal.h>
-#include <netdb.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <ctype.h>
 
 
 ///////////////////
@@ -142,19 +144,38 @@
 
 
 #define MAU_BUFF_LEN    1024
+#define MAU_IN_LEN      (1024*64)   ///< size of buffer used to read addresses
+#define MAU_OUT_LEN     (1024*64)   ///< size of buffer used to write results
+#define MAU_OUT_RECORD  (MAU_BUFF_LEN*2) ///< space reserved for the results of one address
+
+#define MAU_HEX_SEP     0x10        ///< mau_hex value of octet separators
+#define MAU_HEX_BAD     0xff        ///< mau_hex value of invalid characters
 
 
 // definitions providing default parameters for downloading the OUI database
 #define MAU_DOWNLOAD    "http://bindlebinaries.com/bindle-oui.txt"
 //#define MAU_DOWNLOAD    "http://standards.ieee.org/develop/regauth/oui/oui.txt"
-#define MAU_REGEX       "^[[:space:]]{1,}([[:xdigit:]]{2,2})-([[:xdigit:]]{2,2})-([[:xdigit:]]{2,2})" \
-                        "[[:space:]]{1,}\(hex\)" \
+#define MAU_REGEX       "^[[:space:]]{0,}([[:xdigit:]]{2,2})-([[:xdigit:]]{2,2})-([[:xdigit:]]{2,2})" \
+                        "[[:space:]]{1,}\\(hex\\)" \
                         "[[:space:]]{1,}([[:alnum:][:punct:]][[:print:]]{1,})$"
 #define MAU_REGEX_OCT1  1  ///< sub-match index of first octet of MAC address
 #define MAU_REGEX_OCT2  2  ///< sub-match index of second octet of MAC address
 #define MAU_REGEX_OCT3  3  ///< sub-match index of third octet of MAC address
 #define MAU_REGEX_ORG   4  ///< sub-match index of OUI organization name
 #define MAU_REGEX_MAX   20 ///< number of regex sub-matches allowed
+#define MAU_REGEX_BLOCK "^[[:space:]]{0,}([[:xdigit:]]{6,6})-([[:xdigit:]]{6,6})" \
+                        "[[:space:]]{1,}\\(base 16\\)" \
+                        "[[:space:]]{1,}([[:alnum:][:punct:]][[:print:]]{1,})$"
+
+
+// definitions of the compiled OUI index
+#ifndef MAU_DATABASE
+#define MAU_DATABASE    "/usr/local/share/dmstools/macaddrinfo.oui"
+#endif
+#define MAU_DB_MAGIC    "MAUOUI\0\2"  ///< identifies OUI index, last octet is format version
+#define MAU_DB_ORDER    0x01020304     ///< detects index written by host of different byte order
+#define MAU_DB_NONE     0xffffffff     ///< hash slot without record, or empty hash slot
+#define MAU_DB_HASH     0x9e3779b1     ///< multiplier of Fibonacci hashing of OUIs
 
 
 //////////////////
@@ -173,6 +194,90 @@ typedef char    maustr_t[INET6_ADDRSTRLEN+1];
 
 typedef struct mau_config mau_config;
 typedef struct mau_command mau_command;
+typedef struct mau_db mau_db;
+typedef struct mau_db_block mau_db_block;
+typedef struct mau_db_build mau_db_build;
+typedef struct mau_db_header mau_db_header;
+typedef struct mau_db_record mau_db_record;
+typedef struct mau_db_slot mau_db_slot;
+typedef void (*mau_out_func)(mau_config * cnf, const mauaddr_t addr);
+
+/// header of compiled OUI index, followed by records sorted by OUI, by
+/// blocks sorted by OUI and address, and by a pool of organization names
+/// terminated by null characters
+struct mau_db_header
+{
+   char                 magic[8];
+   uint32_t             order;      ///< MAU_DB_ORDER in byte order of writer
+   uint32_t             count;      ///< number of records
+   uint32_t             pool_len;   ///< length of string pool
+   uint32_t             block_count;///< number of blocks
+};
+
+
+/// record of compiled OUI index
+struct mau_db_record
+{
+   uint32_t             oui;        ///< 24-bit OUI
+   uint32_t             org;        ///< offset of organization name in string pool
+};
+
+
+/// block of compiled OUI index, an MA-M or MA-S assignment of part of an
+/// OUI which takes precedence over the record of the OUI
+struct mau_db_block
+{
+   uint32_t             oui;        ///< 24-bit OUI
+   uint32_t             lo;         ///< last three octets of first address of block
+   uint32_t             bits;       ///< length of prefix, 28 for MA-M and 36 for MA-S
+   uint32_t             org;        ///< offset of organization name in string pool
+};
+
+
+/// records, blocks, and organization names collected from OUI listings
+struct mau_db_build
+{
+   mau_db_record      * recs;
+   mau_db_block       * blocks;
+   char               * pool;
+   size_t               count;
+   size_t               block_count;
+   size_t               pool_len;
+   size_t               size;
+   size_t               block_size;
+   size_t               pool_size;
+};
+
+
+/// slot of hash table indexing the records and blocks of an OUI, the
+/// table is built when loading the OUI database to resolve most addresses
+/// with a single probe
+struct mau_db_slot
+{
+   uint32_t             oui;        ///< 24-bit OUI, MAU_DB_NONE if slot is empty
+   uint32_t             rec;        ///< index of record, MAU_DB_NONE if OUI has no record
+   uint32_t             block;      ///< index of first block of OUI
+   uint32_t             blocks;     ///< number of blocks of OUI
+};
+
+
+/// compiled OUI index mapped into memory
+struct mau_db
+{
+   void                * map;
+   size_t                map_len;
+   const mau_db_record * recs;
+   const mau_db_block  * blocks;
+   const char          * pool;
+   mau_db_slot         * slots;
+   uint32_t              count;
+   uint32_t              block_count;
+   uint32_t              pool_len;
+   uint32_t              mask;      ///< number of hash slots minus one
+   uint32_t              shift;     ///< shift of hash to select slot
+   uint32_t              pad32;
+};
+
 
 struct mau_config
 {
@@ -181,15 +286,25 @@ struct mau_config
    int                  notation;
    int                  use_oui;
    int                  opt_index;
+   int                  regex_oct1;
+   int                  regex_oct2;
+   int                  regex_oct3;
+   int                  regex_org;
    int                  cmd_argc;
    char              ** cmd_argv;
    const char         * cmd_name;
    const char         * rnd_file;
+   const char         * in_file;
+   const char         * db_file;
    size_t               cmd_len;
+   char               * out;
+   size_t               out_len;
    const mau_command  * cmd;
    regex_t              regex;
+   regex_t              regex_block;
    const char         * regex_str;
    regmatch_t           matches[MAU_REGEX_MAX];
+   mau_db               db;
    char                 buff[MAU_BUFF_LEN];
    mauaddr_t            oui;
    uint8_t              pad8;
@@ -223,6 +338,15 @@ struct mau_command
 int main(int argc, char * argv[]);
 
 
+// prints vendor of each MAC address
+int mau_cmd_annotate(mau_config * cnf);
+
+// converts the address argument or each address read from a file
+int mau_cmd_each(mau_config * cnf, mau_out_func func);
+
+// prints entire OUI database
+int mau_cmd_dump(mau_config * cnf);
+
 int mau_cmd_eui64(mau_config * cnf);
 
 // generate command
@@ -232,6 +356,9 @@ int mau_cmd_info(mau_config * cnf);
 
 int mau_cmd_link_local(mau_config * cnf);
 
+// prints records and blocks of OUI database
+int mau_cmd_list(mau_config * cnf, const char * str);
+
 int mau_cmd_macaddress(mau_config * cnf);
 
 int mau_cmd_test(mau_config * cnf);
@@ -240,17 +367,37 @@ int mau_cmd_update(mau_config * cnf);
 
 void mau_cmd_update_usage(void);
 
+// searches OUI database for organization
+int mau_cmd_vendor(mau_config * cnf);
+
+size_t mau_conv_bin2hex(char * str, const uint8_t * bytes, size_t len, int notation);
+int mau_conv_buf2mac(mau_config * cnf, const char * str, size_t len, mauaddr_t addr);
 int mau_conv_eui2sin(mau_config * cnf, const maueui64_t eui, struct sockaddr_in6  * sin);
 int mau_conv_eui2str(mau_config * cnf, const maueui64_t eui, maustr_t str);
 int mau_conv_mac2eui(mau_config * cnf, const mauaddr_t addr, maueui64_t eui);
 int mau_conv_mac2str(mau_config * cnf, const mauaddr_t addr, maustr_t str);
 int mau_conv_eui2mac(mau_config * cnf, const maueui64_t eui, mauaddr_t addr);
+int mau_conv_hex2bin(const char * str, size_t len, uint8_t * bytes);
+int mau_conv_in62bin(const char * str, size_t len, uint8_t * bytes);
+size_t mau_conv_in62str(char * str, const uint8_t * bytes);
 int mau_conv_sin2eui(mau_config * cnf, const struct sockaddr_in6 * sin, maueui64_t eui);
 int mau_conv_sin2str(mau_config * cnf, struct sockaddr_in6  * sin, maustr_t str);
 int mau_conv_str2eui(mau_config * cnf, const maustr_t str, maueui64_t eui);
 int mau_conv_str2mac(mau_config * cnf, const maustr_t str, mauaddr_t addr);
 int mau_conv_str2sin(mau_config * cnf, const maustr_t str, struct sockaddr_in6 * sin);
 
+const mau_db_block * mau_db_block_find(const mau_db * db, uint32_t first, uint32_t last,
+   uint32_t oui, uint32_t lo);
+int mau_db_block_cmp(const void * a, const void * b);
+void mau_db_close(mau_config * cnf);
+int mau_db_index(mau_config * cnf);
+const char * mau_db_lookup(const mau_db * db, const mauaddr_t addr);
+int mau_db_open(mau_config * cnf, int required);
+const char * mau_db_org(const mau_db * db, uint32_t org);
+int mau_db_parse(mau_config * cnf, FILE * fs, const char * name, mau_db_build * build);
+int mau_db_record_cmp(const void * a, const void * b);
+int mau_db_write(mau_config * cnf, const mau_db_build * build);
+
 
 int mau_getopt(mau_config * cnf, int argc, char * const * argv,
    const char * short_opt, const struct option * long_opt, int * opt_index);
@@ -266,6 +413,22 @@ void mau_log_warn(mau_config * cnf, const char * fmt, ...);
 
 void mau_logv(mau_config * cnf, const char * fmt, va_list args);
 
+void mau_out_annotate(mau_config * cnf, const mauaddr_t addr);
+void mau_out_eui64(mau_config * cnf, const mauaddr_t addr);
+int  mau_out_flush(mau_config * cnf);
+void mau_out_info(mau_config * cnf, const mauaddr_t addr);
+void mau_out_link_local(mau_config * cnf, const mauaddr_t addr);
+void mau_out_macaddress(mau_config * cnf, const mauaddr_t addr);
+void mau_out_prefix(mau_config * cnf, uint32_t oui, uint32_t lo, uint32_t bits);
+void mau_out_str(mau_config * cnf, const char * str);
+
+// converts each address read from a file
+int mau_stream(mau_config * cnf, mau_out_func func);
+
+// converts a single line read from a file
+int mau_stream_line(mau_config * cnf, mau_out_func func, const char * name,
+   size_t line, const char * str, size_t len);
+
 //displays usage information
 void mau_usage(mau_config * cnf);
 
@@ -283,8 +446,82 @@ void mau_version(void);
 #pragma mark - Variables
 #endif
 
+/// values of hexadecimal digits, MAU_HEX_SEP for the separators of colon,
+/// dash, and dot notation, MAU_HEX_BAD for all other characters
+static const uint8_t mau_hex[256] =
+{
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x10, 0x10, 0xff, // '-' '.'
+   0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0xff, 0xff, 0xff, 0xff, 0xff, // '0' - '9' ':'
+   0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, // 'A' - 'F'
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, // 'a' - 'f'
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+
+/// hexadecimal digits of each octet in lower case and upper case
+static const char mau_hex_digits[2][513] =
+{
+   {
+      "000102030405060708090a0b0c0d0e0f"
+      "101112131415161718191a1b1c1d1e1f"
+      "202122232425262728292a2b2c2d2e2f"
+      "303132333435363738393a3b3c3d3e3f"
+      "404142434445464748494a4b4c4d4e4f"
+      "505152535455565758595a5b5c5d5e5f"
+      "606162636465666768696a6b6c6d6e6f"
+      "707172737475767778797a7b7c7d7e7f"
+      "808182838485868788898a8b8c8d8e8f"
+      "909192939495969798999a9b9c9d9e9f"
+      "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+      "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+      "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+      "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+      "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+      "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"
+   },
+   {
+      "000102030405060708090A0B0C0D0E0F"
+      "101112131415161718191A1B1C1D1E1F"
+      "202122232425262728292A2B2C2D2E2F"
+      "303132333435363738393A3B3C3D3E3F"
+      "404142434445464748494A4B4C4D4E4F"
+      "505152535455565758595A5B5C5D5E5F"
+      "606162636465666768696A6B6C6D6E6F"
+      "707172737475767778797A7B7C7D7E7F"
+      "808182838485868788898A8B8C8D8E8F"
+      "909192939495969798999A9B9C9D9E9F"
+      "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+      "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+      "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+      "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+      "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+      "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF"
+   }
+};
+
+
 const mau_command mau_cmdmap[] =
 {
+   {
+      "annotate",                                     // command name
+      mau_cmd_annotate,                               // entry function
+      "b:cDdf:lRu" MAU_GETOPT_SHORT,                  // getopt short options
+      (struct option []){ MAU_GETOPT_LONG },          // getopt long options
+      0, 0,                                           // min/max arguments
+      NULL,                                           // cli usage
+      "print vendor of each MAC address read from stdin" // command description
+   },
    {
       "debugger",                                     // command name
       mau_cmd_test,                                   // entry function
@@ -298,19 +535,19 @@ const mau_command mau_cmdmap[] =
    },
    {
       "dump",                                         // command name
-      mau_cmd_test,                                   // entry function
-      MAU_GETOPT_SHORT,                               // getopt short options
+      mau_cmd_dump,                                   // entry function
+      "b:cdlRu" MAU_GETOPT_SHORT,                     // getopt short options
       (struct option []){ MAU_GETOPT_LONG },          // getopt long options
       0, 0,                                           // min/max arguments
       NULL,                                           // cli usage
-      NULL, // "print entire OUI database"            // command description
+      "print entire OUI database"                     // command description
    },
    {
       "eui64",                                        // command name
       mau_cmd_eui64,                                  // entry function
-      "lu" MAU_GETOPT_SHORT,                          // getopt short options
+      "f:lu" MAU_GETOPT_SHORT,                        // getopt short options
       (struct option []){ MAU_GETOPT_LONG },          // getopt long options
-      1, 1,                                           // min/max arguments
+      0, 1,                                           // min/max arguments
       " <address>",                                   // cli usage
       "display modified EUI-64 Identifier"            // command description
    },
@@ -334,34 +571,34 @@ const mau_command mau_cmdmap[] =
    {
       "information",                                  // command name
       mau_cmd_info,                                   // entry function
-      "cDdlRu" MAU_GETOPT_SHORT,                      // getopt short options
+      "b:cDdf:lRu" MAU_GETOPT_SHORT,                  // getopt short options
       (struct option []){ MAU_GETOPT_LONG },          // getopt long options
-      1, 1,                                           // min/max arguments
+      0, 1,                                           // min/max arguments
       " <address>",                                   // cli usage
       "display meta information about MAC address"    // command description
    },
    {
       "link-local",                                   // command name
       mau_cmd_link_local,                             // entry function
-      MAU_GETOPT_SHORT,                               // getopt short options
+      "f:" MAU_GETOPT_SHORT,                          // getopt short options
       (struct option []){ MAU_GETOPT_LONG },          // getopt long options
-      1, 1,                                           // min/max arguments
+      0, 1,                                           // min/max arguments
       " <address>",                                   // cli usage
       "display derived IPv6 link-local address"       // command description
    },
    {
       "macaddress",                                   // command name
       mau_cmd_macaddress,                             // entry function
-      "cDdlRu" MAU_GETOPT_SHORT,                      // getopt short options
+      "cDdf:lRu" MAU_GETOPT_SHORT,                    // getopt short options
       (struct option []){ MAU_GETOPT_LONG },          // getopt long options
-      1, 1,                                           // min/max arguments
+      0, 1,                                           // min/max arguments
       " <address>",                                   // cli usage
       "display MAC address using notation flags"      // command description
    },
    {
       "update",                                       // command name
       mau_cmd_update,                                 // entry function
-      "cDdlRUu" MAU_GETOPT_SHORT,                     // getopt short options
+      "1:2:3:f:O:o:r:" MAU_GETOPT_SHORT,              // getopt short options
       (struct option []){ MAU_GETOPT_LONG },          // getopt long options
       0, 0,                                           // min/max arguments
       NULL,                                             // cli usage
@@ -369,12 +606,12 @@ const mau_command mau_cmdmap[] =
    },
    {
       "vendor",                                       // command name
-      mau_cmd_test,                                   // entry function
-      "cDdlRu" MAU_GETOPT_SHORT,                      // getopt short options
+      mau_cmd_vendor,                                 // entry function
+      "b:cdlRu" MAU_GETOPT_SHORT,                     // getopt short options
       (struct option []){ MAU_GETOPT_LONG },          // getopt long options
       1, 1,                                           // min/max arguments
       " <organization>",                              // cli usage
-      NULL, // "search for OUI by vendor name"                 // command description
+      "search for OUI by vendor name"                 // command description
    },
    { NULL, NULL, NULL, NULL, -1, -1, NULL, NULL }
 };
@@ -404,7 +641,12 @@ int main(int argc, char * argv[])
    static struct option long_opt[] = { MAU_GETOPT_LONG };
 
    memset(&cnf, 0, sizeof(cnf));
-   cnf.rnd_file = "/dev/random";
+   cnf.rnd_file   = "/dev/random";
+   cnf.regex_str  = MAU_REGEX;
+   cnf.regex_oct1 = MAU_REGEX_OCT1;
+   cnf.regex_oct2 = MAU_REGEX_OCT2;
+   cnf.regex_oct3 = MAU_REGEX_OCT3;
+   cnf.regex_org  = MAU_REGEX_ORG;
 
    while((c = mau_getopt(&cnf, argc, argv, short_opt, long_opt, &opt_index)) != -1)
    {
@@ -502,9 +744,9 @@ int main(int argc, char * argv[])
       fprintf(stderr, "Try `%s %s --help' for more information.\n", PROGRAM_NAME, cnf.cmd_name);
       return(1);
    };
-   if ((optind+cnf.cmd->max_arg) > cnf.cmd_argc)
+   if ( (cnf.cmd->max_arg != -1) && ((cnf.cmd_argc - optind) > cnf.cmd->max_arg) )
    {
-      fprintf(stderr, "%s: unrecognized argument `-- %s'\n", PROGRAM_NAME, cnf.cmd_argv[optind+1]);
+      fprintf(stderr, "%s: unrecognized argument `-- %s'\n", PROGRAM_NAME, cnf.cmd_argv[optind+cnf.cmd->max_arg]);
       fprintf(stderr, "Try `%s %s --help' for more information.\n", PROGRAM_NAME, cnf.cmd_name);
       return(1);
    };
@@ -513,20 +755,88 @@ int main(int argc, char * argv[])
 }
 
 
-int mau_cmd_eui64(mau_config * cnf)
+/// prints vendor of each MAC address read from stdin or a file, using the
+/// hash table of the OUI database
+int mau_cmd_annotate(mau_config * cnf)
+{
+   int rc;
+
+   if ((mau_db_open(cnf, 1)))
+      return(1);
+   if ((mau_db_index(cnf)))
+   {
+      mau_db_close(cnf);
+      return(1);
+   };
+   if (!(cnf->in_file))
+      cnf->in_file = "-";
+   rc = mau_cmd_each(cnf, mau_out_annotate);
+   mau_db_close(cnf);
+
+   return(rc);
+}
+
+
+/// converts the address argument or, if a file was specified, each address
+/// read from the file
+/// @param[in] cnf    configuration of command
+/// @param[in] func   function which appends the results of an address
+int mau_cmd_each(mau_config * cnf, mau_out_func func)
 {
+   int            rc;
    mauaddr_t      addr;
-   maueui64_t     eui;
-   maustr_t       eui_str;
 
-   if ((mau_conv_str2mac(cnf, cnf->cmd_argv[optind], addr)))
+   if ( (!(cnf->in_file)) && (optind >= cnf->cmd_argc) )
+   {
+      fprintf(stderr, "%s: missing required argument\n", PROGRAM_NAME);
+      fprintf(stderr, "Try `%s %s --help' for more information.\n", PROGRAM_NAME, cnf->cmd_name);
       return(1);
-   mau_conv_mac2eui(cnf, addr, eui);
-   mau_conv_eui2str(cnf, eui, eui_str);
+   };
+   if ( ((cnf->in_file)) && (optind < cnf->cmd_argc) )
+   {
+      fprintf(stderr, "%s: unrecognized argument `-- %s'\n", PROGRAM_NAME, cnf->cmd_argv[optind]);
+      fprintf(stderr, "Try `%s %s --help' for more information.\n", PROGRAM_NAME, cnf->cmd_name);
+      return(1);
+   };
 
-   printf("%s\n", eui_str);
+   if ((cnf->out = malloc(MAU_OUT_LEN)) == NULL)
+   {
+      mau_log_err(cnf, "out of virtual memory\n");
+      return(1);
+   };
+   cnf->out_len = 0;
 
-   return(0);
+   if ((cnf->in_file))
+   {
+      rc = mau_stream(cnf, func);
+   }
+   else if ((rc = mau_conv_str2mac(cnf, cnf->cmd_argv[optind], addr)) != 0)
+   {
+      mau_log_err(cnf, "invalid MAC address\n");
+   }
+   else
+   {
+      func(cnf, addr);
+      rc = mau_out_flush(cnf);
+   };
+
+   free(cnf->out);
+   cnf->out = NULL;
+
+   return(rc);
+}
+
+
+/// prints each OUI and organization of the OUI database
+int mau_cmd_dump(mau_config * cnf)
+{
+   return(mau_cmd_list(cnf, NULL));
+}
+
+
+int mau_cmd_eui64(mau_config * cnf)
+{
+   return(mau_cmd_each(cnf, mau_out_eui64));
 }
 
 
@@ -570,65 +880,106 @@ int mau_cmd_generate(mau_config * cnf)
 
 int mau_cmd_info(mau_config * cnf)
 {
-   mauaddr_t      addr;
-   maustr_t       addr_str;
-   maueui64_t     eui;
-   maustr_t       eui_str;
-   maustr_t       sin_str;
-   struct sockaddr_in6   sin;
+   int rc;
 
-   if ((mau_conv_str2mac(cnf, cnf->cmd_argv[optind], addr)))
+   // the vendor is only reported if the OUI database is available
+   if ((mau_db_open(cnf, ((cnf->db_file)) ? 1 : 0)))
       return(1);
+   if ( ((cnf->in_file)) && ((cnf->db.map)) && ((mau_db_index(cnf))) )
+   {
+      mau_db_close(cnf);
+      return(1);
+   };
+   rc = mau_cmd_each(cnf, mau_out_info);
+   mau_db_close(cnf);
 
-   mau_conv_mac2str(cnf, addr, addr_str);
-   mau_conv_mac2eui(cnf, addr, eui);
-   mau_conv_eui2str(cnf, eui, eui_str);
-   mau_conv_eui2sin(cnf, eui, &sin);
-   mau_conv_sin2str(cnf, &sin, sin_str);
-
-   printf("MAC Address:      %s\n", addr_str);
-   printf("U/L Bit:          %s\n", ((addr[0] & 0x02) == 0x02) ? "1 (locally administered)" : "0 (universally administered)");
-   printf("Multicast Bit:    %s\n", ((addr[0] & 0x01) == 0x01) ? "1 (multicast)" : "0 (unicast)");
-   printf("Modified EUI-64:  %s\n", eui_str);
-   printf("IPv6 Link-local:  %s\n", sin_str);
-
-   return(0);
+   return(rc);
 }
 
 
 int mau_cmd_link_local(mau_config * cnf)
 {
-   mauaddr_t      addr;
-   maueui64_t     eui;
-   maustr_t       sin_str;
-   struct sockaddr_in6   sin;
+   return(mau_cmd_each(cnf, mau_out_link_local));
+}
 
-   if ((mau_conv_str2mac(cnf, cnf->cmd_argv[optind], addr)))
+
+/// prints records and blocks of the OUI database in order of address, the
+/// records of an OUI precede the blocks of the OUI
+/// @param[in] cnf    configuration of command
+/// @param[in] str    string contained in organizations, ignoring case, or
+///                   NULL to print all records
+int mau_cmd_list(mau_config * cnf, const char * str)
+{
+   int                    rc;
+   uint32_t               u;
+   uint32_t               v;
+   size_t                 len;
+   const char           * org;
+   const char           * pos;
+   const mau_db         * db;
+   const mau_db_block   * blk;
+   const mau_db_record  * rec;
+
+   len = ((str)) ? strlen(str) : 0;
+   db  = &cnf->db;
+
+   if ((mau_db_open(cnf, 1)))
       return(1);
+   if ((cnf->out = malloc(MAU_OUT_LEN)) == NULL)
+   {
+      mau_log_err(cnf, "out of virtual memory\n");
+      mau_db_close(cnf);
+      return(1);
+   };
+   cnf->out_len = 0;
 
-   mau_conv_mac2eui(cnf, addr, eui);
-   mau_conv_eui2sin(cnf, eui, &sin);
-   mau_conv_sin2str(cnf, &sin, sin_str);
+   rc = 0;
+   for(u = 0, v = 0; ( ((u < db->count) || (v < db->block_count)) && (!(rc)) ); )
+   {
+      if ( (v == db->block_count) || ((u < db->count) && (db->recs[u].oui <= db->blocks[v].oui)) )
+      {
+         rec = &db->recs[u++];
+         blk = NULL;
+         org = mau_db_org(db, rec->org);
+      }
+      else
+      {
+         rec = NULL;
+         blk = &db->blocks[v++];
+         org = mau_db_org(db, blk->org);
+      };
+      if (org == NULL)
+         continue;
+      if ((str))
+      {
+         for(pos = org; ((*pos) && ((strncasecmp(pos, str, len)))); pos++);
+         if (!(*pos))
+            continue;
+      };
+      if ((cnf->out_len + MAU_OUT_RECORD) > MAU_OUT_LEN)
+         rc = mau_out_flush(cnf);
+      if ((rec))
+         mau_out_prefix(cnf, rec->oui, 0, 24);
+      else
+         mau_out_prefix(cnf, blk->oui, blk->lo, blk->bits);
+      cnf->out[cnf->out_len++] = '\t';
+      mau_out_str(cnf, org);
+      cnf->out[cnf->out_len++] = '\n';
+   };
+   if (!(rc))
+      rc = mau_out_flush(cnf);
 
-   printf("%s\n", sin_str);
+   free(cnf->out);
+   cnf->out = NULL;
+   mau_db_close(cnf);
 
-   return(0);
+   return(rc);
 }
 
 
 int mau_cmd_macaddress(mau_config * cnf)
 {
-   maustr_t       str;
-   mauaddr_t      addr;
-
-   if ((mau_conv_str2mac(cnf, cnf->cmd_argv[optind], addr)))
-      return(1);
-
-   mau_conv_mac2str(cnf, addr, str);
-
-   printf("%s\n", str);
-
-   return(0);
+   return(mau_cmd_each(cnf, mau_out_macaddress));
 }
 
 
@@ -639,10 +990,99 @@ int mau_cmd_test(mau_config * cnf)
 }
 
 
+/// compiles an OUI listing in text form into the OUI database
 int mau_cmd_update(mau_config * cnf)
 {
-   printf("%s\n", cnf->cmd_name);
-   return(0);
+   int              rc;
+   int              err;
+   size_t           u;
+   size_t           v;
+   size_t           dups;
+   FILE           * fs;
+   mau_db_build     build;
+   char             msg[MAU_BUFF_LEN];
+
+   if (!(cnf->in_file))
+   {
+      fprintf(stderr, "%s: missing required option `-f'\n", PROGRAM_NAME);
+      fprintf(stderr, "Try `%s %s --help' for more information.\n", PROGRAM_NAME, cnf->cmd_name);
+      return(1);
+   };
+
+   if ((err = regcomp(&cnf->regex, cnf->regex_str, REG_EXTENDED)) != 0)
+   {
+      regerror(err, &cnf->regex, msg, sizeof(msg));
+      mau_log_err(cnf, "regex: %s\n", msg);
+      return(1);
+   };
+   if ( ((size_t)cnf->regex_oct1 > cnf->regex.re_nsub) || ((size_t)cnf->regex_oct2 > cnf->regex.re_nsub) ||
+        ((size_t)cnf->regex_oct3 > cnf->regex.re_nsub) || ((size_t)cnf->regex_org  > cnf->regex.re_nsub) )
+   {
+      mau_log_err(cnf, "regex: sub-match index exceeds number of sub-expressions\n");
+      regfree(&cnf->regex);
+      return(1);
+   };
+   if ((err = regcomp(&cnf->regex_block, MAU_REGEX_BLOCK, REG_EXTENDED)) != 0)
+   {
+      regerror(err, &cnf->regex_block, msg, sizeof(msg));
+      mau_log_err(cnf, "regex: %s\n", msg);
+      regfree(&cnf->regex);
+      return(1);
+   };
+
+   if (!(strcmp(cnf->in_file, "-")))
+   {
+      fs = stdin;
+   }
+   else if ((fs = fopen(cnf->in_file, "r")) == NULL)
+   {
+      mau_log_err(cnf, "%s: %s\n", cnf->in_file, strerror(errno));
+      regfree(&cnf->regex);
+      regfree(&cnf->regex_block);
+      return(1);
+   };
+
+   memset(&build, 0, sizeof(build));
+   rc = mau_db_parse(cnf, fs, ((fs == stdin) ? "stdin" : cnf->in_file), &build);
+
+   if (fs != stdin)
+      fclose(fs);
+   regfree(&cnf->regex);
+   regfree(&cnf->regex_block);
+   if ((rc))
+      return(1);
+
+   // sorts by OUI, duplicates keep the organization listed first
+   qsort(build.recs, build.count, sizeof(mau_db_record), mau_db_record_cmp);
+   for(u = 1, dups = build.count, build.count = ((build.count)) ? 1 : 0; u < dups; u++)
+      if (build.recs[u].oui != build.recs[build.count-1].oui)
+         build.recs[build.count++] = build.recs[u];
+   dups -= build.count;
+
+   // sorts by address, blocks overlapping a block at a lower address or a
+   // block listed earlier at the same address are discarded
+   if ((build.block_count))
+      qsort(build.blocks, build.block_count, sizeof(mau_db_block), mau_db_block_cmp);
+   for(u = 1, v = ((build.block_count)) ? 1 : 0; u < build.block_count; u++)
+   {
+      if ( (build.blocks[u].oui == build.blocks[v-1].oui) &&
+           ((build.blocks[u].lo - build.blocks[v-1].lo) < (1U << (48 - build.blocks[v-1].bits))) )
+         continue;
+      build.blocks[v++] = build.blocks[u];
+   };
+   dups += build.block_count - v;
+   build.block_count = v;
+
+   mau_log_verbose(cnf, "%lu records, %lu blocks, %lu duplicates\n",
+      (unsigned long)build.count, (unsigned long)build.block_count, (unsigned long)dups);
+
+   rc = mau_db_write(cnf, &build);
+
+   free(build.recs);
+   free(build.blocks);
+   free(build.pool);
+
+   return(rc);
 }
 
 
@@ -653,15 +1093,108 @@ void mau_cmd_update_usage(void)
       "  -1 idx                    index of REGEX sub-match for first octet of OUI\n"
       "  -2 idx                    index of REGEX sub-match for second octet of OUI\n"
       "  -3 idx                    index of REGEX sub-match for third octet of OUI\n"
+      "  -f file                   OUI listing in text form, - for stdin\n"
       "  -r regex                  regulare expression matching a single record in the OUI database\n"
       "  -O idx                    index of REGEX sub-match for OUI organization\n"
       "  -o file                   output file to save formatted OUI database\n"
-      "  -u url                    download URL for source OUI database\n"
+      "                            (default: %s)\n"
+      "Lines of MA-M, MA-S, and IAB listings giving address ranges in base 16\n"
+      "are compiled as blocks of the OUI on the preceding line, listings may\n"
+      "be concatenated on stdin.\n"
+      "OUI listings may be downloaded from:\n"
+      "  %s\n",
+      MAU_DATABASE, MAU_DOWNLOAD
    );
    return;
 }
 
 
+/// prints each OUI whose organization contains a string, ignoring case
+int mau_cmd_vendor(mau_config * cnf)
+{
+   return(mau_cmd_list(cnf, cnf->cmd_argv[optind]));
+}
+
+
+/// formats octets as hexadecimal digits in colon, dash, dot, or raw notation
+/// and returns the length of the text, which is terminated
+/// @param[out] str       buffer of at least three characters per octet
+/// @param[in]  bytes     octets to format
+/// @param[in]  len       number of octets
+/// @param[in]  notation  MAU_NOTATION_* and MAU_CASE_* flags
+size_t mau_conv_bin2hex(char * str, const uint8_t * bytes, size_t len, int notation)
+{
+   size_t         pos;
+   size_t         u;
+   char           sep;
+   const char   * digits;
+
+   digits = mau_hex_digits[(MAU_CASE(notation) == MAU_CASE_UPPER) ? 1 : 0];
+
+   switch(MAU_NOTATION(notation))
+   {
+      case MAU_NOTATION_DASH:
+      sep = '-';
+      break;
+
+      case MAU_NOTATION_DOT:
+      sep = '.';
+      break;
+
+      case MAU_NOTATION_RAW:
+      sep = '\0';
+      break;
+
+      default:
+      sep = ':';
+      break;
+   };
+
+   pos = 0;
+   for(u = 0; u < len; u++)
+   {
+      // dot notation separates pairs of octets
+      if ( (u > 0) && (sep != '\0') && ((sep != '.') || (!(u & 0x01))) )
+         str[pos++] = sep;
+      str[pos++] = digits[(bytes[u] << 1) + 0];
+      str[pos++] = digits[(bytes[u] << 1) + 1];
+   };
+   str[pos] = '\0';
+
+   return(pos);
+}
+
+
+/// converts a MAC address, EUI-64, or IPv6 address which is not terminated
+/// into a MAC address
+/// @param[in]  cnf    configuration of command
+/// @param[in]  str    text of address
+/// @param[in]  len    length of text
+/// @param[out] addr   MAC address
+int mau_conv_buf2mac(mau_config * cnf, const char * str, size_t len, mauaddr_t addr)
+{
+   uint8_t bytes[16];
+
+   switch(mau_conv_hex2bin(str, len, bytes))
+   {
+      case 6:
+      memcpy(addr, bytes, 6);
+      return(0);
+
+      case 8:
+      return(mau_conv_eui2mac(cnf, bytes, addr));
+
+      default:
+      break;
+   };
+
+   if ((mau_conv_in62bin(str, len, bytes)))
+      return(1);
+
+   return(mau_conv_eui2mac(cnf, &bytes[8], addr));
+}
+
+
 int mau_conv_eui2mac(mau_config * cnf, const maueui64_t eui, maueui64_t addr)
 {
    assert(cnf != NULL);
@@ -689,79 +1222,292 @@ int mau_conv_eui2sin(mau_config * cnf, const maueui64_t eui, struct sockaddr_in6
 
 int mau_conv_eui2str(mau_config * cnf, const maueui64_t eui, maustr_t str)
 {
-   switch (cnf->notation & MAU_MASK_CASE)
-   {
-      case MAU_CASE_LOWER:
-      snprintf(str, sizeof(maustr_t), "%02x-%02x-%02x-%02x-%02x-%02x-%02x-%02x", eui[0],eui[1],eui[2],eui[3],eui[4],eui[5],eui[6],eui[7]);
-      break;
-
-      case MAU_CASE_UPPER:
-      default:
-      snprintf(str, sizeof(maustr_t), "%02X-%02X-%02X-%02X-%02X-%02X-%02X-%02X", eui[0],eui[1],eui[2],eui[3],eui[4],eui[5],eui[6],eui[7]);
-      break;
-   }
+   mau_conv_bin2hex(str, eui, 8, MAU_SET_NOTATION(cnf->notation, MAU_NOTATION_DASH));
    return(0);
 }
 
 
-int mau_conv_mac2eui(mau_config * cnf, const mauaddr_t addr, maueui64_t eui)
+/// parses a MAC address or EUI-64 in colon, dash, dot, or raw notation in a
+/// single pass, returns the number of octets or 0 if the text is invalid
+/// @param[in]  str    text of address
+/// @param[in]  len    length of text
+/// @param[out] bytes  buffer of at least 8 octets
+int mau_conv_hex2bin(const char * str, size_t len, uint8_t * bytes)
 {
-   assert(cnf  != NULL);
-   assert(eui  != NULL);
-   assert(addr != NULL);
-
-   eui[0] = (addr[0] ^ 0x02);
-   eui[1] =  addr[1];
-   eui[2] =  addr[2];
-   eui[3] =  0xff;
-   eui[4] =  0xfe;
-   eui[5] =  addr[3];
-   eui[6] =  addr[4];
-   eui[7] =  addr[5];
-
-   return(0);
-}
+   size_t   pos;
+   size_t   digits;
+   size_t   width;
+   size_t   nibbles;
+   char     sep;
+   uint8_t  val;
+
+   // longest notation is an EUI-64 in colon or dash notation
+   if (len > 23)
+      return(0);
 
+   sep     = '\0';
+   width   = 0;
+   digits  = 0;
+   nibbles = 0;
 
-int mau_conv_mac2str(mau_config * cnf, const mauaddr_t addr, maustr_t str)
-{
-   switch (cnf->notation | (MAU_MASK_NOTATION & MAU_MASK_CASE))
+   for(pos = 0; pos < len; pos++)
    {
-      case (MAU_NOTATION_COLON | MAU_CASE_LOWER):
-      snprintf(str, sizeof(maustr_t), "%02x:%02x:%02x:%02x:%02x:%02x", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
-      break;
+      val = mau_hex[(uint8_t)str[pos]];
 
-      case (MAU_NOTATION_COLON | MAU_CASE_UPPER):
-      snprintf(str, sizeof(maustr_t), "%02X:%02X:%02X:%02X:%02X:%02X", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
-      break;
+      if (val < 0x10)
+      {
+         if (nibbles == 16)
+            return(0);
+         if ((nibbles & 0x01))
+            bytes[nibbles >> 1] |= val;
+         else
+            bytes[nibbles >> 1]  = (uint8_t)(val << 4);
+         nibbles++;
+         digits++;
+         continue;
+      };
 
-      case (MAU_NOTATION_DASH | MAU_CASE_LOWER):
-      snprintf(str, sizeof(maustr_t), "%02x-%02x-%02x-%02x-%02x-%02x", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
-      break;
+      if (val != MAU_HEX_SEP)
+         return(0);
 
-      case (MAU_NOTATION_DASH | MAU_CASE_UPPER):
-      snprintf(str, sizeof(maustr_t), "%02X-%02X-%02X-%02X-%02X-%02X", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
-      break;
+      // the first separator determines the notation and width of groups
+      if (sep == '\0')
+      {
+         sep   = str[pos];
+         width = (sep == '.') ? 4 : 2;
+      };
+      if ( (str[pos] != sep) || (digits != width) )
+         return(0);
+      digits = 0;
+   };
 
-      case (MAU_NOTATION_DOT | MAU_CASE_LOWER):
-      snprintf(str, sizeof(maustr_t), "%02x%02x.%02x%02x.%02x%02x", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
-      break;
+   if ( (sep != '\0') && (digits != width) )
+      return(0);
+   if ( (nibbles != 12) && (nibbles != 16) )
+      return(0);
 
-      case (MAU_NOTATION_DOT | MAU_CASE_UPPER):
-      snprintf(str, sizeof(maustr_t), "%02X%02X.%02X%02X.%02X%02X", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
-      break;
+   return((int)(nibbles >> 1));
+}
 
-      case (MAU_NOTATION_RAW | MAU_CASE_LOWER):
-      snprintf(str, sizeof(maustr_t), "%02x%02x%02x%02x%02x%02x", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
-      break;
 
-      case (MAU_NOTATION_RAW | MAU_CASE_UPPER):
-      snprintf(str, sizeof(maustr_t), "%02X%02X%02X%02X%02X%02X", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
-      break;
+/// parses an IPv6 address in text form without the resolver, a zone index
+/// following a percent sign is ignored
+/// @param[in]  str    text of address
+/// @param[in]  len    length of text
+/// @param[out] bytes  buffer of at least 16 octets
+int mau_conv_in62bin(const char * str, size_t len, uint8_t * bytes)
+{
+   size_t         pos;
+   size_t         start;
+   size_t         digits;
+   size_t         groups;
+   size_t         gap;
+   unsigned       val;
+   unsigned       oct;
+   uint8_t        hex;
+   uint8_t        buff[16];
+   const char   * zone;
+
+   if ((zone = memchr(str, '%', len)) != NULL)
+      len = (size_t)(zone - str);
+   if (len < 2)
+      return(1);
 
-      default:
-      snprintf(str, sizeof(maustr_t), "%02x:%02x:%02x:%02x:%02x:%02x", addr[0],addr[1],addr[2],addr[3],addr[4],addr[5]);
+   groups = 0;
+   gap    = 9;
+   pos    = 0;
+
+   if ( (str[0] == ':') && (str[1] != ':') )
+      return(1);
+   if (str[0] == ':')
+   {
+      gap = 0;
+      pos = 2;
+   };
+
+   while (pos < len)
+   {
+      if (groups == 8)
+         return(1);
+
+      start  = pos;
+      val    = 0;
+      digits = 0;
+      for(; ((pos < len) && ((hex = mau_hex[(uint8_t)str[pos]]) < 0x10)); pos++)
+      {
+         if (++digits > 4)
+            return(1);
+         val = (val << 4) | hex;
+      };
+
+      // embedded IPv4 address in dotted decimal notation
+      if ( (pos < len) && (str[pos] == '.') )
+      {
+         if (groups > 6)
+            return(1);
+         for(pos = start, oct = 0; oct < 4; oct++, pos++)
+         {
+            val    = 0;
+            digits = 0;
+            for(; ((pos < len) && (str[pos] >= '0') && (str[pos] <= '9')); pos++, digits++)
+               val = (val * 10) + (unsigned)(str[pos] - '0');
+            if ( (digits < 1) || (digits > 3) || (val > 255) )
+               return(1);
+            if ( (digits > 1) && (str[pos-digits] == '0') )
+               return(1);
+            if ( (oct < 3) && ((pos >= len) || (str[pos] != '.')) )
+               return(1);
+            buff[(groups*2) + oct] = (uint8_t)val;
+         };
+         if (pos != (len+1))
+            return(1);
+         groups += 2;
+         break;
+      };
+
+      if (digits == 0)
+         return(1);
+      buff[(groups*2)+0] = (uint8_t)(val >> 8);
+      buff[(groups*2)+1] = (uint8_t)(val & 0xff);
+      groups++;
+
+      if (pos == len)
+         break;
+      if (str[pos] != ':')
+         return(1);
+      if (++pos == len)
+         return(1);
+      if (str[pos] == ':')
+      {
+         if (gap != 9)
+            return(1);
+         gap = groups;
+         pos++;
+      };
+   };
+
+   // expands the compressed groups
+   if (gap == 9)
+   {
+      if (groups != 8)
+         return(1);
+      memcpy(bytes, buff, 16);
+      return(0);
+   };
+   if (groups > 7)
+      return(1);
+   memset(bytes, 0, 16);
+   memcpy(bytes, buff, gap*2);
+   memcpy(&bytes[16 - ((groups-gap)*2)], &buff[gap*2], (groups-gap)*2);
+
+   return(0);
+}
+
+
+/// formats an IPv6 address in the canonical text form of RFC 5952 without
+/// the resolver and returns the length of the text, which is terminated
+/// @param[out] str    buffer of at least INET6_ADDRSTRLEN characters
+/// @param[in]  bytes  octets of address
+size_t mau_conv_in62str(char * str, const uint8_t * bytes)
+{
+   size_t         pos;
+   size_t         u;
+   size_t         run;
+   size_t         best;
+   size_t         best_len;
+   unsigned       val;
+   unsigned       words[8];
+   static const char hex[] = "0123456789abcdef";
+
+   // finds the first longest run of zero groups
+   best     = 8;
+   best_len = 0;
+   run      = 0;
+   for(u = 0; u < 8; u++)
+   {
+      words[u] = ((unsigned)bytes[u*2] << 8) | bytes[(u*2)+1];
+      run      = (words[u] == 0) ? run+1 : 0;
+      if (run > best_len)
+      {
+         best     = u + 1 - run;
+         best_len = run;
+      };
+   };
+   if (best_len < 2)
+   {
+      best     = 8;
+      best_len = 0;
+   };
+
+   pos = 0;
+   for(u = 0; u < 8; u++)
+   {
+      if ( (u >= best) && (u < (best + best_len)) )
+      {
+         if (u == best)
+            str[pos++] = ':';
+         continue;
+      };
+      if (u != 0)
+         str[pos++] = ':';
+
+      // IPv4-compatible and IPv4-mapped addresses end in dotted decimal
+      if ( (u == 6) && (best == 0) && ((best_len == 6) || ((best_len == 5) && (words[5] == 0xffff))) )
+      {
+         for(u = 12; u < 16; u++)
+         {
+            val = bytes[u];
+            if (val >= 100)
+               str[pos++] = (char)('0' + (val / 100));
+            if (val >= 10)
+               str[pos++] = (char)('0' + ((val / 10) % 10));
+            str[pos++] = (char)('0' + (val % 10));
+            if (u < 15)
+               str[pos++] = '.';
+         };
+         str[pos] = '\0';
+         return(pos);
+      };
+
+      val = words[u];
+      if (val >= 0x1000)
+         str[pos++] = hex[val >> 12];
+      if (val >= 0x100)
+         str[pos++] = hex[(val >> 8) & 0x0f];
+      if (val >= 0x10)
+         str[pos++] = hex[(val >> 4) & 0x0f];
+      str[pos++] = hex[val & 0x0f];
    };
+   if ( (best_len > 0) && ((best + best_len) == 8) )
+      str[pos++] = ':';
+   str[pos] = '\0';
+
+   return(pos);
+}
+
+
+int mau_conv_mac2eui(mau_config * cnf, const mauaddr_t addr, maueui64_t eui)
+{
+   assert(cnf  != NULL);
+   assert(eui  != NULL);
+   assert(addr != NULL);
+
+   eui[0] = (addr[0] ^ 0x02);
+   eui[1] =  addr[1];
+   eui[2] =  addr[2];
+   eui[3] =  0xff;
+   eui[4] =  0xfe;
+   eui[5] =  addr[3];
+   eui[6] =  addr[4];
+   eui[7] =  addr[5];
+
+   return(0);
+}
+
+
+int mau_conv_mac2str(mau_config * cnf, const mauaddr_t addr, maustr_t str)
+{
+   mau_conv_bin2hex(str, addr, 6, cnf->notation);
    return(0);
 }
 
@@ -777,45 +1523,30 @@ int mau_conv_sin2eui(mau_config * cnf, const struct sockaddr_in6 * sin, maueui64
 int mau_conv_sin2str(mau_config * cnf, struct sockaddr_in6  * sin, maustr_t str)
 {
    assert(cnf != NULL);
-   getnameinfo((struct sockaddr *)sin, sizeof(struct sockaddr_in6), str, sizeof(maustr_t), NULL, 0, NI_NUMERICHOST|NI_NUMERICSERV);
+   mau_conv_in62str(str, sin->sin6_addr.s6_addr);
    return(0);
 }
 
 
 int mau_conv_str2eui(mau_config * cnf, const maustr_t str, maueui64_t eui)
 {
-   int    buff[8];
-   size_t slen;
-   int    len;
-   int    i;
-   struct sockaddr_in6 sin;
+   size_t  len;
+   uint8_t bytes[16];
 
    assert(cnf  != NULL);
    assert(str  != NULL);
    assert(eui != NULL);
 
-   if (!(mau_conv_str2sin(cnf, str, &sin)))
+   len = strlen(str);
+
+   if (mau_conv_hex2bin(str, len, bytes) == 8)
    {
-      mau_conv_sin2eui(cnf, &sin, eui);
+      memcpy(eui, bytes, 8);
       return(0);
    };
-
-   slen = strlen(str);
-   len  = 0;
-
-   if (slen == 23)
-      len = sscanf(str, "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", &buff[0],&buff[1],&buff[2],&buff[3],&buff[4],&buff[5],&buff[6],&buff[7]);
-   if ((slen == 23) && (len != 8))
-      len = sscanf(str, "%02x-%02x-%02x-%02x-%02x-%02x-%02x-%02x", &buff[0],&buff[1],&buff[2],&buff[3],&buff[4],&buff[5],&buff[6],&buff[7]);
-   if ((slen == 19) && (len != 8))
-      len = sscanf(str, "%02X%02X.%02X%02X.%02X%02X.%02X%02X", &buff[0],&buff[1],&buff[2],&buff[3],&buff[4],&buff[5],&buff[6],&buff[7]);
-   if ((slen == 16) && (len != 8))
-      len = sscanf(str, "%02X%02X%02X%02X%02X%02X%02X%02X", &buff[0],&buff[1],&buff[2],&buff[3],&buff[4],&buff[5],&buff[6],&buff[7]);
-   if (len != 8)
+   if ((mau_conv_in62bin(str, len, bytes)))
       return(1);
-
-   for(i = 0; i < 8; i++)
-      eui[i] = (uint8_t) buff[i];
+   memcpy(eui, &bytes[8], 8);
 
    return(0);
 }
@@ -823,64 +1554,556 @@ int mau_conv_str2eui(mau_config * cnf, const maustr_t str, maueui64_t eui)
 
 int mau_conv_str2mac(mau_config * cnf, const maustr_t str, mauaddr_t addr)
 {
-   maueui64_t eui;
-   int        buff[6];
-   size_t     slen;
-   int        len;
-   int        i;
-
    assert(str  != NULL);
    assert(addr != NULL);
+   return(mau_conv_buf2mac(cnf, str, strlen(str), addr));
+}
+
 
-   if (!(mau_conv_str2eui(cnf, str, eui)))
+int mau_conv_str2sin(mau_config * cnf, const maustr_t str, struct sockaddr_in6 * sin)
+{
+   assert(cnf  != NULL);
+   assert(str  != NULL);
+   assert(sin != NULL);
+
+   memset(sin, 0, sizeof(struct sockaddr_in6));
+   sin->sin6_family = AF_INET6;
+
+   return(mau_conv_in62bin(str, strlen(str), sin->sin6_addr.s6_addr));
+}
+
+
+/// searches blocks of the OUI database for the block containing an
+/// address, the blocks of an OUI do not overlap
+/// @param[in] db     OUI database
+/// @param[in] first  index of first block to search
+/// @param[in] last   index following last block to search
+/// @param[in] oui    first three octets of address
+/// @param[in] lo     last three octets of address
+const mau_db_block * mau_db_block_find(const mau_db * db, uint32_t first, uint32_t last,
+   uint32_t oui, uint32_t lo)
+{
+   uint32_t               low;
+   uint32_t               high;
+   uint32_t               mid;
+   const mau_db_block   * blk;
+
+   // finds last block starting at or below address
+   low  = first;
+   high = last;
+   while (low < high)
    {
-      mau_conv_eui2mac(cnf, eui, addr);
-      return(0);
+      mid = low + ((high - low) >> 1);
+      blk = &db->blocks[mid];
+      if ( (blk->oui < oui) || ((blk->oui == oui) && (blk->lo <= lo)) )
+         low  = mid + 1;
+      else
+         high = mid;
    };
+   if (low == first)
+      return(NULL);
+
+   blk = &db->blocks[low-1];
+   if ( (blk->oui != oui) || (blk->bits <= 24) || (blk->bits >= 48) )
+      return(NULL);
+   if ((lo - blk->lo) >= (1U << (48 - blk->bits)))
+      return(NULL);
+
+   return(blk);
+}
+
+
+/// orders blocks by address, then by position in string pool which follows
+/// the order of the OUI listing
+int mau_db_block_cmp(const void * a, const void * b)
+{
+   const mau_db_block * x = a;
+   const mau_db_block * y = b;
+   if (x->oui != y->oui)
+      return((x->oui < y->oui) ? -1 : 1);
+   if (x->lo != y->lo)
+      return((x->lo < y->lo) ? -1 : 1);
+   if (x->org != y->org)
+      return((x->org < y->org) ? -1 : 1);
+   return(0);
+}
+
+
+/// unmaps OUI database
+void mau_db_close(mau_config * cnf)
+{
+   if ((cnf->db.map))
+      munmap(cnf->db.map, cnf->db.map_len);
+   free(cnf->db.slots);
+   memset(&cnf->db, 0, sizeof(cnf->db));
+   return;
+}
 
-   slen = strlen(str);
-   len  = 0;
 
-   if (slen == 17)
-      len = sscanf(str, "%02x:%02x:%02x:%02x:%02x:%02x", &buff[0],&buff[1],&buff[2],&buff[3],&buff[4],&buff[5]);
-   if ((slen == 17) && (len != 6))
-      len = sscanf(str, "%02x-%02x-%02x-%02x-%02x-%02x", &buff[0],&buff[1],&buff[2],&buff[3],&buff[4],&buff[5]);
-   if ((slen == 14) && (len != 6))
-      len = sscanf(str, "%02X%02X.%02X%02X.%02X%02X", &buff[0],&buff[1],&buff[2],&buff[3],&buff[4],&buff[5]);
-   if ((slen == 12) && (len != 6))
-      len = sscanf(str, "%02X%02X%02X%02X%02X%02X", &buff[0],&buff[1],&buff[2],&buff[3],&buff[4],&buff[5]);
-   if (len != 6)
+/// builds hash table of the OUIs of the records and blocks, the table has
+/// at least twice as many slots as OUIs to keep probe sequences short
+/// @param[in] cnf    configuration of command
+int mau_db_index(mau_config * cnf)
+{
+   uint32_t          u;
+   uint32_t          n;
+   uint32_t          pos;
+   uint32_t          oui;
+   uint32_t          bits;
+   mau_db          * db;
+   mau_db_slot     * slot;
+
+   db = &cnf->db;
+
+   for(n = 1024, bits = 10; ((n >> 1) < (db->count + db->block_count)); n <<= 1, bits++);
+   if ((db->slots = malloc(sizeof(mau_db_slot) * n)) == NULL)
    {
-      mau_log_err(cnf, "invalid MAC address\n");
+      mau_log_err(cnf, "out of virtual memory\n");
       return(1);
    };
+   for(u = 0; u < n; u++)
+   {
+      db->slots[u].oui    = MAU_DB_NONE;
+      db->slots[u].rec    = MAU_DB_NONE;
+      db->slots[u].block  = 0;
+      db->slots[u].blocks = 0;
+   };
+   db->mask  = n - 1;
+   db->shift = 32 - bits;
 
-   for(i = 0; i < 6; i++)
-      addr[i] = (uint8_t) buff[i];
+   // inserts records followed by the blocks of each OUI
+   for(u = 0; u < (db->count + db->block_count); u++)
+   {
+      oui = (u < db->count) ? db->recs[u].oui : db->blocks[u - db->count].oui;
+      for(pos = (oui * MAU_DB_HASH) >> db->shift; ((db->slots[pos].oui != MAU_DB_NONE) && (db->slots[pos].oui != oui)); pos = (pos + 1) & db->mask);
+      slot      = &db->slots[pos];
+      slot->oui = oui;
+      if (u < db->count)
+      {
+         slot->rec = u;
+      }
+      else if ((slot->blocks++) == 0)
+      {
+         slot->block = u - db->count;
+      };
+   };
 
    return(0);
 }
 
 
-int mau_conv_str2sin(mau_config * cnf, const maustr_t str, struct sockaddr_in6 * sin)
+/// searches OUI database for the organization of an address, the block
+/// containing the address takes precedence over the record of its OUI
+/// @param[in] db     OUI database
+/// @param[in] addr   MAC address
+const char * mau_db_lookup(const mau_db * db, const mauaddr_t addr)
 {
-   struct addrinfo    hints;
-   struct addrinfo  * servinfo;
+   uint32_t               oui;
+   uint32_t               lo;
+   uint32_t               rec;
+   uint32_t               first;
+   uint32_t               last;
+   uint32_t               low;
+   uint32_t               high;
+   uint32_t               mid;
+   uint32_t               pos;
+   const mau_db_block   * blk;
+
+   oui = ((uint32_t)addr[0] << 16) | ((uint32_t)addr[1] << 8) | addr[2];
+   lo  = ((uint32_t)addr[3] << 16) | ((uint32_t)addr[4] << 8) | addr[5];
+
+   if ((db->slots))
+   {
+      // probes hash table
+      for(pos = (oui * MAU_DB_HASH) >> db->shift; (db->slots[pos].oui != oui); pos = (pos + 1) & db->mask)
+         if (db->slots[pos].oui == MAU_DB_NONE)
+            return(NULL);
+      rec   = db->slots[pos].rec;
+      first = db->slots[pos].block;
+      last  = first + db->slots[pos].blocks;
+   }
+   else
+   {
+      // searches sorted records
+      low  = 0;
+      high = db->count;
+      while (low < high)
+      {
+         mid = low + ((high - low) >> 1);
+         if (db->recs[mid].oui < oui)
+            low  = mid + 1;
+         else
+            high = mid;
+      };
+      rec   = ( (low == db->count) || (db->recs[low].oui != oui) ) ? MAU_DB_NONE : low;
+      first = 0;
+      last  = db->block_count;
+   };
 
-   assert(cnf  != NULL);
-   assert(str  != NULL);
-   assert(sin != NULL);
+   if ( (first < last) && ((blk = mau_db_block_find(db, first, last, oui, lo)) != NULL) )
+      return(mau_db_org(db, blk->org));
+   if (rec == MAU_DB_NONE)
+      return(NULL);
+
+   return(mau_db_org(db, db->recs[rec].org));
+}
+
+
+/// maps OUI database into memory, the records, blocks, and string pool are
+/// used in place and are not parsed
+/// @param[in] cnf       configuration of command
+/// @param[in] required  report an error if the database does not exist
+int mau_db_open(mau_config * cnf, int required)
+{
+   int                     fd;
+   const char            * file;
+   struct stat             sb;
+   const mau_db_header   * hdr;
+
+   memset(&cnf->db, 0, sizeof(cnf->db));
+   file = ((cnf->db_file)) ? cnf->db_file : MAU_DATABASE;
+
+   if ((fd = open(file, O_RDONLY)) == -1)
+   {
+      if ( (!(required)) && (errno == ENOENT) )
+         return(0);
+      mau_log_err(cnf, "%s: %s\n", file, strerror(errno));
+      return(1);
+   };
+   if (fstat(fd, &sb) == -1)
+   {
+      mau_log_err(cnf, "%s: %s\n", file, strerror(errno));
+      close(fd);
+      return(1);
+   };
+   if ((size_t)sb.st_size < sizeof(mau_db_header))
+   {
+      mau_log_err(cnf, "%s: invalid OUI database\n", file);
+      close(fd);
+      return(1);
+   };
 
-   memset(&hints, 0, sizeof(hints));
-   hints.ai_family   = AF_INET6;      // use AF_UNSPEC, AF_INET, or AF_INET6
-   hints.ai_socktype = SOCK_STREAM;
-   hints.ai_flags    = AI_ADDRCONFIG | AI_PASSIVE | AI_NUMERICSERV | AI_NUMERICHOST;
-   if (getaddrinfo(str, NULL, &hints, &servinfo) != 0)
+   cnf->db.map_len = (size_t)sb.st_size;
+   if ((cnf->db.map = mmap(NULL, cnf->db.map_len, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED)
+   {
+      mau_log_err(cnf, "%s: %s\n", file, strerror(errno));
+      memset(&cnf->db, 0, sizeof(cnf->db));
+      close(fd);
       return(1);
+   };
+   close(fd);
 
-   memset(sin, 0, sizeof(struct sockaddr_in6));
-   sin->sin6_family = AF_INET6;
-   memcpy(sin, servinfo->ai_addr, sizeof(struct sockaddr_in6));
+   hdr = cnf->db.map;
+   if ( ((memcmp(hdr->magic, MAU_DB_MAGIC, sizeof(hdr->magic)))) ||
+        (hdr->order != MAU_DB_ORDER) ||
+        (hdr->count > ((cnf->db.map_len - sizeof(mau_db_header)) / sizeof(mau_db_record))) ||
+        (hdr->block_count > ((cnf->db.map_len - sizeof(mau_db_header)) / sizeof(mau_db_block))) ||
+        (cnf->db.map_len != (sizeof(mau_db_header) + ((size_t)hdr->count * sizeof(mau_db_record)) +
+                             ((size_t)hdr->block_count * sizeof(mau_db_block)) + hdr->pool_len)) )
+   {
+      mau_log_err(cnf, "%s: invalid OUI database\n", file);
+      mau_db_close(cnf);
+      return(1);
+   };
+
+   cnf->db.count       = hdr->count;
+   cnf->db.block_count = hdr->block_count;
+   cnf->db.pool_len    = hdr->pool_len;
+   cnf->db.recs        = (const mau_db_record *)&hdr[1];
+   cnf->db.blocks      = (const mau_db_block *)&cnf->db.recs[hdr->count];
+   cnf->db.pool        = (const char *)&cnf->db.blocks[hdr->block_count];
+
+   return(0);
+}
+
+
+/// returns organization of record or block, or NULL if the offset is corrupt
+/// @param[in] db     OUI database
+/// @param[in] org    offset of organization in string pool
+const char * mau_db_org(const mau_db * db, uint32_t org)
+{
+   size_t len;
+
+   if (org >= db->pool_len)
+      return(NULL);
+
+   // limits names to the length of lines accepted by update
+   len = db->pool_len - org;
+   len = (len < MAU_BUFF_LEN) ? len : MAU_BUFF_LEN;
+   if (memchr(&db->pool[org], '\0', len) == NULL)
+      return(NULL);
+
+   return(&db->pool[org]);
+}
+
+
+/// collects OUI records from lines of an OUI listing matching the regular
+/// expression, and blocks from lines of MA-M, MA-S, and IAB listings matching
+/// MAU_REGEX_BLOCK, which give the range of the last three octets assigned
+/// within the OUI of the preceding line and replace its record
+/// @param[in]  cnf        configuration of command
+/// @param[in]  fs         stream of OUI listing
+/// @param[in]  name       name of OUI listing used in messages
+/// @param[out] build      unsorted records, blocks, and organization names
+int mau_db_parse(mau_config * cnf, FILE * fs, const char * name, mau_db_build * build)
+{
+   int               c;
+   int               i;
+   int               idx[3];
+   size_t            len;
+   size_t            line;
+   size_t            pending;
+   uint8_t           hi;
+   uint8_t           lo;
+   uint32_t          bits;
+   uint64_t          first;
+   uint64_t          last;
+   void            * ptr;
+   const char      * org;
+   regmatch_t      * m;
+
+   idx[0] = cnf->regex_oct1;
+   idx[1] = cnf->regex_oct2;
+   idx[2] = cnf->regex_oct3;
+   line   = 0;
+
+   // line number of the last record appended, which a range on the
+   // following line converts into a block
+   pending = 0;
+
+   while (fgets(cnf->buff, sizeof(cnf->buff), fs) != NULL)
+   {
+      line++;
+      len = strlen(cnf->buff);
+
+      // skips lines longer than buffer
+      if ( (len == (sizeof(cnf->buff)-1)) && (cnf->buff[len-1] != '\n') )
+      {
+         mau_log_warn(cnf, "%s:%lu: line too long\n", name, (unsigned long)line);
+         while ( ((c = fgetc(fs)) != EOF) && (c != '\n') );
+         continue;
+      };
+      while ( (len > 0) && ((cnf->buff[len-1] == '\n') || (cnf->buff[len-1] == '\r')) )
+         cnf->buff[--len] = '\0';
+
+      if (!(regexec(&cnf->regex, cnf->buff, MAU_REGEX_MAX, cnf->matches, 0)))
+      {
+         // converts octets of OUI
+         for(i = 0, first = 0; i < 3; i++)
+         {
+            m = &cnf->matches[idx[i]];
+            if ((m->rm_eo - m->rm_so) != 2)
+               break;
+            hi = mau_hex[(uint8_t)cnf->buff[m->rm_so+0]];
+            lo = mau_hex[(uint8_t)cnf->buff[m->rm_so+1]];
+            if ( (hi > 0x0f) || (lo > 0x0f) )
+               break;
+            first = (first << 8) | (uint32_t)(hi << 4) | lo;
+         };
+         m = &cnf->matches[cnf->regex_org];
+         if ( (i < 3) || (m->rm_so == -1) )
+         {
+            mau_log_warn(cnf, "%s:%lu: invalid OUI record\n", name, (unsigned long)line);
+            continue;
+         };
+         first <<= 24;
+         bits    = 24;
+      }
+      else if (!(regexec(&cnf->regex_block, cnf->buff, MAU_REGEX_MAX, cnf->matches, 0)))
+      {
+         // ranges give the last three octets of addresses within the OUI
+         // of the record on the preceding line
+         if ( (!(pending)) || (pending != (line - 1)) )
+         {
+            mau_log_warn(cnf, "%s:%lu: OUI block without OUI record\n", name, (unsigned long)line);
+            continue;
+         };
+         pending = 0;
+
+         // converts first and last address of range, which the regular
+         // expression limits to six hexadecimal digits
+         for(i = 0, first = last = build->recs[build->count-1].oui; i < 6; i++)
+         {
+            first = (first << 4) | mau_hex[(uint8_t)cnf->buff[cnf->matches[1].rm_so+i]];
+            last  = (last  << 4) | mau_hex[(uint8_t)cnf->buff[cnf->matches[2].rm_so+i]];
+         };
+
+         // ranges must be aligned blocks within the OUI, ranges of an
+         // entire OUI leave the record in place
+         for(bits = 48; ((bits > 24) && ((first >> (48 - bits)) < (last >> (48 - bits)))); bits--);
+         if ( (bits == 24) && ((first & 0xffffff) == 0) && ((last & 0xffffff) == 0xffffff) )
+            continue;
+         if ( (bits == 24) || (bits == 48) || ((first >> (48 - bits)) != (last >> (48 - bits))) ||
+              ((first & ((1ULL << (48 - bits)) - 1)) != 0) || ((~last & ((1ULL << (48 - bits)) - 1)) != 0) )
+         {
+            mau_log_warn(cnf, "%s:%lu: invalid OUI block\n", name, (unsigned long)line);
+            continue;
+         };
+
+         // the record of the OUI names the assignee of the block only
+         build->count--;
+         build->pool_len = build->recs[build->count].org;
+         m = &cnf->matches[3];
+      }
+      else
+      {
+         continue;
+      };
+
+      // trims organization
+      org = &cnf->buff[m->rm_so];
+      len = (size_t)(m->rm_eo - m->rm_so);
+      while ( (len > 0) && ((isspace((unsigned char)org[len-1]))) )
+         len--;
+      if (len == 0)
+         continue;
+
+      // appends record or block and organization
+      if ( (bits == 24) && (build->count == build->size) )
+      {
+         build->size = ((build->size)) ? build->size * 2 : 1024;
+         if ((ptr = realloc(build->recs, sizeof(mau_db_record) * build->size)) == NULL)
+            break;
+         build->recs = ptr;
+      };
+      if ( (bits != 24) && (build->block_count == build->block_size) )
+      {
+         build->block_size = ((build->block_size)) ? build->block_size * 2 : 1024;
+         if ((ptr = realloc(build->blocks, sizeof(mau_db_block) * build->block_size)) == NULL)
+            break;
+         build->blocks = ptr;
+      };
+      if ((build->pool_len + len + 1) > build->pool_size)
+      {
+         build->pool_size = ((build->pool_size)) ? build->pool_size * 2 : (1024 * 64);
+         if ((ptr = realloc(build->pool, build->pool_size)) == NULL)
+            break;
+         build->pool = ptr;
+      };
+      if (bits == 24)
+      {
+         build->recs[build->count].oui = (uint32_t)(first >> 24);
+         build->recs[build->count].org = (uint32_t)build->pool_len;
+         build->count++;
+         pending = line;
+      }
+      else
+      {
+         build->blocks[build->block_count].oui  = (uint32_t)(first >> 24);
+         build->blocks[build->block_count].lo   = (uint32_t)(first & 0xffffff);
+         build->blocks[build->block_count].bits = bits;
+         build->blocks[build->block_count].org  = (uint32_t)build->pool_len;
+         build->block_count++;
+      };
+      memcpy(&build->pool[build->pool_len], org, len);
+      build->pool[build->pool_len + len] = '\0';
+      build->pool_len += len + 1;
+   };
+
+   if ( (!(feof(fs))) || ((build->count + build->block_count) == 0) )
+   {
+      if (!(feof(fs)))
+         mau_log_err(cnf, "%s: %s\n", name, ((ferror(fs))) ? strerror(errno) : "out of virtual memory");
+      else
+         mau_log_err(cnf, "%s: no OUI records found\n", name);
+      free(build->recs);
+      free(build->blocks);
+      free(build->pool);
+      memset(build, 0, sizeof(mau_db_build));
+      return(1);
+   };
+
+   return(0);
+}
+
+
+/// orders records by OUI, then by position in string pool which follows the
+/// order of the OUI listing
+int mau_db_record_cmp(const void * a, const void * b)
+{
+   const mau_db_record * x = a;
+   const mau_db_record * y = b;
+   if (x->oui != y->oui)
+      return((x->oui < y->oui) ? -1 : 1);
+   if (x->org != y->org)
+      return((x->org < y->org) ? -1 : 1);
+   return(0);
+}
+
+
+/// writes the OUI database to a temporary file which replaces the database
+/// once complete, so processes mapping the previous database are unaffected
+int mau_db_write(mau_config * cnf, const mau_db_build * build)
+{
+   int               fd;
+   size_t            u;
+   size_t            pos;
+   ssize_t           len;
+   char            * tmp;
+   const char      * file;
+   mau_db_header     hdr;
+   struct iovec      iov[4];
+
+   file = ((cnf->db_file)) ? cnf->db_file : MAU_DATABASE;
+
+   memset(&hdr, 0, sizeof(hdr));
+   memcpy(hdr.magic, MAU_DB_MAGIC, sizeof(hdr.magic));
+   hdr.order    = MAU_DB_ORDER;
+   hdr.count       = (uint32_t)build->count;
+   hdr.pool_len    = (uint32_t)build->pool_len;
+   hdr.block_count = (uint32_t)build->block_count;
+
+   if ((tmp = malloc(strlen(file) + 8)) == NULL)
+   {
+      mau_log_err(cnf, "out of virtual memory\n");
+      return(1);
+   };
+   sprintf(tmp, "%s.XXXXXX", file);
+   if ((fd = mkstemp(tmp)) == -1)
+   {
+      mau_log_err(cnf, "%s: %s\n", file, strerror(errno));
+      free(tmp);
+      return(1);
+   };
+   mau_log_verbose(cnf, "writing %s\n", file);
+
+   iov[0].iov_base = &hdr;
+   iov[0].iov_len  = sizeof(hdr);
+   iov[1].iov_base = build->recs;
+   iov[1].iov_len  = sizeof(mau_db_record) * build->count;
+   iov[2].iov_base = build->blocks;
+   iov[2].iov_len  = sizeof(mau_db_block) * build->block_count;
+   iov[3].iov_base = build->pool;
+   iov[3].iov_len  = build->pool_len;
+
+   // writes vectors, resuming after partial writes
+   for(u = 0, len = 0; ((u < 4) && (len != -1)); )
+   {
+      if ((len = writev(fd, &iov[u], (int)(4 - u))) == -1)
+      {
+         if (errno == EINTR)
+            len = 0;
+         continue;
+      };
+      for(pos = (size_t)len; ((u < 4) && (pos >= iov[u].iov_len)); u++)
+         pos -= iov[u].iov_len;
+      if (u < 4)
+      {
+         iov[u].iov_base  = (char *)iov[u].iov_base + pos;
+         iov[u].iov_len  -= pos;
+      };
+   };
+
+   if ( (len == -1) || (fchmod(fd, 0644) == -1) || (close(fd) == -1) || (rename(tmp, file) == -1) )
+   {
+      mau_log_err(cnf, "%s: %s\n", file, strerror(errno));
+      if (len == -1)
+         close(fd);
+      unlink(tmp);
+      free(tmp);
+      return(1);
+   };
+   free(tmp);
 
    return(0);
 }
@@ -890,6 +2113,8 @@ int mau_getopt(mau_config * cnf, int argc, char * const * argv,
    const char * short_opt, const struct option * long_opt, int * opt_index)
 {
    int            c;
+   int            idx;
+   char         * end;
 
    c = getopt_long(argc, argv, short_opt, long_opt, opt_index);
 
@@ -933,6 +2158,30 @@ int mau_getopt(mau_config * cnf, int argc, char * const * argv,
       };
       return(-2);
 
+      case '1':
+      case '2':
+      case '3':
+      case 'O':
+      idx = ((optarg)) ? (int)strtol(optarg, &end, 10) : 0;
+      if ( (!(optarg)) || ((*end)) || (idx < 1) || (idx >= MAU_REGEX_MAX) )
+      {
+         mau_log_err(cnf, "sub-match index must be between 1 and %i\n", MAU_REGEX_MAX-1);
+         return(2);
+      };
+      switch(c)
+      {
+         case '1': cnf->regex_oct1 = idx; break;
+         case '2': cnf->regex_oct2 = idx; break;
+         case '3': cnf->regex_oct3 = idx; break;
+         default:  cnf->regex_org  = idx; break;
+      };
+      return(-2);
+
+      case 'b':
+      case 'o':
+      cnf->db_file = optarg;
+      return(-2);
+
       case 'c':
       cnf->notation = MAU_SET_NOTATION(cnf->notation, MAU_NOTATION_COLON);
       return(-2);
@@ -941,6 +2190,10 @@ int mau_getopt(mau_config * cnf, int argc, char * const * argv,
       cnf->notation = MAU_SET_NOTATION(cnf->notation, MAU_NOTATION_DOT);
       return(-2);
 
+      case 'f':
+      cnf->in_file = optarg;
+      return(-2);
+
       case 'd':
       cnf->notation = MAU_SET_NOTATION(cnf->notation, MAU_NOTATION_DASH);
       return(-2);
@@ -962,7 +2215,10 @@ int mau_getopt(mau_config * cnf, int argc, char * const * argv,
       return(-2);
 
       case 'r':
-      cnf->rnd_file = optarg;
+      if ( ((cnf->cmd)) && (cnf->cmd->cmd_func == mau_cmd_update) )
+         cnf->regex_str = optarg;
+      else
+         cnf->rnd_file = optarg;
       return(-2);
 
       case 'u':
@@ -1070,6 +2326,301 @@ void mau_logv(mau_config * cnf, const char * fmt, va_list args)
 }
 
 
+/// appends address and vendor separated by a tab
+void mau_out_annotate(mau_config * cnf, const mauaddr_t addr)
+{
+   const char   * org;
+
+   cnf->out_len += mau_conv_bin2hex(&cnf->out[cnf->out_len], addr, 6, cnf->notation);
+   cnf->out[cnf->out_len++] = '\t';
+   mau_out_str(cnf, ((org = mau_db_lookup(&cnf->db, addr)) != NULL) ? org : "unknown");
+   cnf->out[cnf->out_len++] = '\n';
+
+   return;
+}
+
+
+void mau_out_eui64(mau_config * cnf, const mauaddr_t addr)
+{
+   maueui64_t     eui;
+
+   mau_conv_mac2eui(cnf, addr, eui);
+
+   cnf->out_len += mau_conv_bin2hex(&cnf->out[cnf->out_len], eui, 8, MAU_SET_NOTATION(cnf->notation, MAU_NOTATION_DASH));
+   cnf->out[cnf->out_len++] = '\n';
+
+   return;
+}
+
+
+/// writes buffered results to stdout
+int mau_out_flush(mau_config * cnf)
+{
+   size_t         pos;
+   ssize_t        len;
+
+   for(pos = 0; pos < cnf->out_len; pos += (size_t)len)
+   {
+      if ((len = write(STDOUT_FILENO, &cnf->out[pos], cnf->out_len - pos)) == -1)
+      {
+         if (errno == EINTR)
+         {
+            len = 0;
+            continue;
+         };
+         mau_log_err(cnf, "stdout: %s\n", strerror(errno));
+         return(1);
+      };
+   };
+   cnf->out_len = 0;
+
+   return(0);
+}
+
+
+void mau_out_info(mau_config * cnf, const mauaddr_t addr)
+{
+   const char   * org;
+   maustr_t       addr_str;
+   maueui64_t     eui;
+   maustr_t       eui_str;
+   maustr_t       sin_str;
+   struct sockaddr_in6   sin;
+
+   mau_conv_mac2str(cnf, addr, addr_str);
+   mau_conv_mac2eui(cnf, addr, eui);
+   mau_conv_eui2str(cnf, eui, eui_str);
+   mau_conv_eui2sin(cnf, eui, &sin);
+   mau_conv_sin2str(cnf, &sin, sin_str);
+
+   mau_out_str(cnf, "MAC Address:      ");
+   mau_out_str(cnf, addr_str);
+   if ((cnf->db.map))
+   {
+      mau_out_str(cnf, "\nOUI Vendor:       ");
+      mau_out_str(cnf, ((org = mau_db_lookup(&cnf->db, addr)) != NULL) ? org : "unknown");
+   };
+   mau_out_str(cnf, "\nU/L Bit:          ");
+   mau_out_str(cnf, ((addr[0] & 0x02) == 0x02) ? "1 (locally administered)" : "0 (universally administered)");
+   mau_out_str(cnf, "\nMulticast Bit:    ");
+   mau_out_str(cnf, ((addr[0] & 0x01) == 0x01) ? "1 (multicast)" : "0 (unicast)");
+   mau_out_str(cnf, "\nModified EUI-64:  ");
+   mau_out_str(cnf, eui_str);
+   mau_out_str(cnf, "\nIPv6 Link-local:  ");
+   mau_out_str(cnf, sin_str);
+   mau_out_str(cnf, "\n");
+
+   // separates the records of addresses read from a file
+   if ((cnf->in_file))
+      mau_out_str(cnf, "\n");
+
+   return;
+}
+
+
+void mau_out_link_local(mau_config * cnf, const mauaddr_t addr)
+{
+   uint8_t        in6[16];
+
+   // fe80::/64 followed by the modified EUI-64
+   memset(in6, 0, 8);
+   in6[0] = 0xfe;
+   in6[1] = 0x80;
+   mau_conv_mac2eui(cnf, addr, &in6[8]);
+
+   cnf->out_len += mau_conv_in62str(&cnf->out[cnf->out_len], in6);
+   cnf->out[cnf->out_len++] = '\n';
+
+   return;
+}
+
+
+void mau_out_macaddress(mau_config * cnf, const mauaddr_t addr)
+{
+   cnf->out_len += mau_conv_bin2hex(&cnf->out[cnf->out_len], addr, 6, cnf->notation);
+   cnf->out[cnf->out_len++] = '\n';
+   return;
+}
+
+
+/// appends OUI, or first address and prefix length of a block
+/// @param[in] cnf    configuration of command
+/// @param[in] oui    24-bit OUI
+/// @param[in] lo     last three octets of first address of block
+/// @param[in] bits   length of prefix, 24 for the records of an OUI
+void mau_out_prefix(mau_config * cnf, uint32_t oui, uint32_t lo, uint32_t bits)
+{
+   uint8_t        addr[6];
+
+   addr[0] = (uint8_t)(oui >> 16);
+   addr[1] = (uint8_t)(oui >>  8);
+   addr[2] = (uint8_t)(oui >>  0);
+   addr[3] = (uint8_t)(lo  >> 16);
+   addr[4] = (uint8_t)(lo  >>  8);
+   addr[5] = (uint8_t)(lo  >>  0);
+
+   if (bits == 24)
+   {
+      cnf->out_len += mau_conv_bin2hex(&cnf->out[cnf->out_len], addr, 3, cnf->notation);
+      return;
+   };
+   cnf->out_len += mau_conv_bin2hex(&cnf->out[cnf->out_len], addr, 6, cnf->notation);
+   cnf->out_len += (size_t)sprintf(&cnf->out[cnf->out_len], "/%u", (unsigned)bits);
+
+   return;
+}
+
+
+/// appends string to buffered results, the caller must ensure
+/// MAU_OUT_RECORD bytes are available before appending the results of an
+/// address
+void mau_out_str(mau_config * cnf, const char * str)
+{
+   size_t len;
+   len = strlen(str);
+   memcpy(&cnf->out[cnf->out_len], str, len);
+   cnf->out_len += len;
+   return;
+}
+
+
+/// converts each address read from a file, one address per line
+/// @param[in] cnf    configuration of command
+/// @param[in] func   function which appends the results of an address
+int mau_stream(mau_config * cnf, mau_out_func func)
+{
+   int            fd;
+   int            rc;
+   int            skip;
+   ssize_t        len;
+   size_t         line;
+   size_t         pos;
+   size_t         used;
+   char         * buff;
+   char         * eol;
+   const char   * name;
+
+   if (!(strcmp(cnf->in_file, "-")))
+   {
+      fd   = STDIN_FILENO;
+      name = "stdin";
+   }
+   else if ((fd = open(cnf->in_file, O_RDONLY)) == -1)
+   {
+      mau_log_err(cnf, "%s: %s\n", cnf->in_file, strerror(errno));
+      return(1);
+   }
+   else
+   {
+      name = cnf->in_file;
+   };
+
+   if ((buff = malloc(MAU_IN_LEN)) == NULL)
+   {
+      mau_log_err(cnf, "out of virtual memory\n");
+      if (fd != STDIN_FILENO)
+         close(fd);
+      return(1);
+   };
+
+   rc   = 0;
+   skip = 0;
+   line = 0;
+   used = 0;
+
+   while ((len = read(fd, &buff[used], MAU_IN_LEN - used)) != 0)
+   {
+      if (len == -1)
+      {
+         if (errno == EINTR)
+            continue;
+         mau_log_err(cnf, "%s: %s\n", name, strerror(errno));
+         rc = -1;
+         break;
+      };
+      used += (size_t)len;
+
+      // converts each complete line in buffer
+      for(pos = 0; ((eol = memchr(&buff[pos], '\n', used - pos)) != NULL); pos = (size_t)(eol - buff) + 1)
+      {
+         line++;
+         if ((skip))
+            skip = 0;
+         else if ((len = mau_stream_line(cnf, func, name, line, &buff[pos], (size_t)(eol - &buff[pos]))) != 0)
+            rc = (int)len;
+         if (rc == -1)
+            break;
+      };
+      if (rc == -1)
+         break;
+      memmove(buff, &buff[pos], used - pos);
+      used -= pos;
+
+      // discards lines which do not fit in buffer
+      if (used == MAU_IN_LEN)
+      {
+         if (!(skip))
+            mau_log_err(cnf, "%s:%lu: invalid MAC address\n", name, (unsigned long)(line+1));
+         rc   = 1;
+         skip = 1;
+         used = 0;
+      };
+   };
+
+   // converts last line if not terminated by a newline
+   if ( (rc != -1) && (used > 0) && (!(skip)) )
+      if ((len = mau_stream_line(cnf, func, name, line+1, buff, used)) != 0)
+         rc = (int)len;
+
+   if ( (rc != -1) && ((mau_out_flush(cnf))) )
+      rc = -1;
+
+   free(buff);
+   if (fd != STDIN_FILENO)
+      close(fd);
+
+   return((rc)?1:0);
+}
+
+
+/// converts a single line read from a file
+/// @param[in] cnf    configuration of command
+/// @param[in] func   function which appends the results of an address
+/// @param[in] name   name of file used in error messages
+/// @param[in] line   line number used in error messages
+/// @param[in] str    contents of line, not terminated
+/// @param[in] len    length of line
+int mau_stream_line(mau_config * cnf, mau_out_func func, const char * name,
+   size_t line, const char * str, size_t len)
+{
+   mauaddr_t      addr;
+
+   // trims surrounding white space and carriage returns
+   while ( (len > 0) && ((isspace((unsigned char)str[len-1]))) )
+      len--;
+   while ( (len > 0) && ((isspace((unsigned char)str[0]))) )
+   {
+      str++;
+      len--;
+   };
+   if (len == 0)
+      return(0);
+
+   if ((mau_conv_buf2mac(cnf, str, len, addr)))
+   {
+      mau_log_err(cnf, "%s:%lu: invalid MAC address\n", name, (unsigned long)line);
+      return(1);
+   };
+
+   if ((cnf->out_len + MAU_OUT_RECORD) > MAU_OUT_LEN)
+      if ((mau_out_flush(cnf)))
+         return(-1);
+   func(cnf, addr);
+
+   return(0);
+}
+
+
 /// displays usage information
 void mau_usage(mau_config * cnf)
 {
@@ -1087,11 +2638,16 @@ void mau_usage(mau_config * cnf)
       cmd_help  = ((cnf->cmd->cmd_help)) ? cnf->cmd->cmd_help : "";
    };
 
+   if ( ((cnf->cmd)) && (cnf->cmd->cmd_func == mau_cmd_update) )
+      shortopts = MAU_GETOPT_SHORT;
+
    printf("Usage: %s %s [OPTIONS]%s\n", PROGRAM_NAME, cmd_name, cmd_help);
    printf("OPTIONS:\n");
+   if ((strchr(shortopts, 'b'))) printf("  -b file                   OUI database (default: %s)\n", MAU_DATABASE);
    if ((strchr(shortopts, 'c'))) printf("  -c, --colon               print MAC addresses in colon notation\n");
    if ((strchr(shortopts, 'D'))) printf("  -D, --dot                 print MAC addresses in dot notation\n");
    if ((strchr(shortopts, 'd'))) printf("  -d, --dash                print MAC addresses in dash notation\n");
+   if ((strchr(shortopts, 'f'))) printf("  -f file                   read one address per line from file, - for stdin\n");
    if ((strchr(shortopts, 'h'))) printf("  -h, --help                print this help and exit\n");
    if ((strchr(shortopts, 'l'))) printf("  -l, --lower               print HEX digits in lower case\n");
    if ((strchr(shortopts, 'q'))) printf("  -q, --quiet, --silent     do not print messages\n");
@@ -1106,6 +2662,8 @@ void mau_usage(mau_config * cnf)
    if ((strchr(shortopts, 'Q'))) printf("  --qemu                    generate MAC address for QEMU/KVM\n");
    if ((strchr(shortopts, 'W'))) printf("  --vmware                  generate MAC address for VMWare\n");
    if ((strchr(shortopts, 'X'))) printf("  --xen                     generate MAC address for Xen\n");
+   if ( ((cnf->cmd)) && (cnf->cmd->cmd_func == mau_cmd_update) )
+      mau_cmd_update_usage();
    if (!(cnf->cmd))
    {
       printf("COMMANDS:\n");
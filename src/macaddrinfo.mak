@@ -1,10 +1,20 @@
 macaddrinfo.oui.txt:
 	curl -o macaddrinfo.oui.txt http://standards.ieee.org/develop/regauth/oui/oui.txt
 
+macaddrinfo.mam.txt:
+	curl -o macaddrinfo.mam.txt http://standards-oui.ieee.org/oui28/mam.txt
+
+macaddrinfo.oui36.txt:
+	curl -o macaddrinfo.oui36.txt http://standards-oui.ieee.org/oui36/oui36.txt
+
 macaddrinfo: Makefile macaddrinfo.c macaddrinfo.mak macaddrinfo.oui.txt
 	$(LIBTOOL) --mode=compile --tag=CC $(CC) $(CFLAGS) -c macaddrinfo.c
 	$(LIBTOOL) --mode=link    --tag=CC $(CC) $(CFLAGS) -o macaddrinfo macaddrinfo.lo
 
+macaddrinfo.oui: macaddrinfo macaddrinfo.oui.txt macaddrinfo.mam.txt macaddrinfo.oui36.txt
+	cat macaddrinfo.oui.txt macaddrinfo.mam.txt macaddrinfo.oui36.txt \
+	   | ./macaddrinfo update -f - -o macaddrinfo.oui
+
 macaddrinfo-clean:
-	$(LIBTOOL) --mode=clean rm -f macaddrinfo.lo macaddrinfo
+	$(LIBTOOL) --mode=clean rm -f macaddrinfo.lo macaddrinfo macaddrinfo.oui
 
@@ -38,17 +38,19 @@
 /*
  *  Simple Build:
  *     gcc -W -Wall -O2 -c recurse.c
- *     gcc -W -Wall -O2 -o recurse   recurse.o
+ *     gcc -W -Wall -O2 -c walk.c
+ *     gcc -W -Wall -O2 -o recurse   recurse.o walk.o -lpthread
  *
  *  GNU Libtool Build:
  *     libtool --mode=compile gcc -W -Wall -g -O2 -c recurse.c
- *     libtool --mode=link    gcc -W -Wall -g -O2 -o recurse recurse.lo
+ *     libtool --mode=compile gcc -W -Wall -g -O2 -c walk.c
+ *     libtool --mode=link    gcc -W -Wall -g -O2 -o recurse recurse.lo walk.lo -lpthread
  *
  *  GNU Libtool Install:
  *     libtool --mode=install install -c recurse /usr/local/bin/recurse
  *
  *  GNU Libtool Clean:
- *     libtool --mode=clean rm -f recurse.lo recurse
+ *     libtool --mode=clean rm -f recurse.lo walk.lo recurse
  */
 #define _DMSTOOLS_SRC_RECURSE_C 1
 
@@ -61,14 +63,17 @@
 #ifdef HAVE_COMMON_H
 #include "common.h"
 #endif
+#include "walk.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <getopt.h>
 #include <string.h>
 #include <errno.h>
-#include <sys/stat.h>
-#include <dirent.h>
+#include <unistd.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/wait.h>
 
 ///////////////////
 //               //
@@ -96,6 +101,54 @@
 #define MY_OPT_FORCE       0x10
 #define MY_OPT_LINKS       0x20
 #define MY_OPT_QUIET       0x40
+#define MY_OPT_NULL        0x80
+#define MY_OPT_EXEC        0x100
+
+#define MY_OUTPUT_SIZE     (1024*64)   ///< size of stdout buffer when listing paths
+#define MY_EXEC_MARGIN     2048        ///< bytes of ARG_MAX left unused by exec batches
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+
+typedef struct my_state MyState;
+
+
+///////////////
+//           //
+//  Structs  //
+//           //
+///////////////
+
+/// options and pending exec batch shared by walk callbacks
+struct my_state
+{
+   int               opts;       ///< MY_OPT_* flags
+   int               status;     ///< non-zero if a command failed
+   char              delim;      ///< character printed after each path
+   char              pad[3];
+   char            * command;    ///< copy of command string split into argv
+   char           ** argv;       ///< command, initial arguments, and queued paths
+   size_t            base;       ///< number of command and initial arguments
+   size_t            count;      ///< number of arguments in argv
+   size_t            size;       ///< number of elements allocated in argv
+   size_t            used;       ///< bytes of ARG_MAX used by argv
+   size_t            used_base;  ///< bytes of ARG_MAX used by initial arguments
+   size_t            limit;      ///< bytes of ARG_MAX available to argv
+   pthread_mutex_t   lock;       ///< serializes exec batches
+};
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+
+extern char ** environ;
 
 
 //////////////////
@@ -112,12 +165,15 @@ void my_usage(void);
 
 int my_work(const char * file, void * data);
 
-int recurse_directory(char * origin, int opts, void * data,
-   int (*func)(const char * file, int opts, void * data));
+int my_entry(const WalkEntry * entry, void * data);
 
-int recurse_file(const char * file, int opts, void * data,
-   int (*func)(const char * file, int opts, void * data), unsigned * countp,
-   char *** queuep, unsigned * sizep);
+int my_exec_add(MyState * state, const char * path);
+
+void my_exec_free(MyState * state);
+
+int my_exec_init(MyState * state, const char * command);
+
+int my_exec_run(MyState * state);
 
 
 /////////////////
@@ -130,11 +186,13 @@ int main(int argc, char * argv[])
 {
    int        c;
    int        i;
-   int        opts;
+   int        rc;
    int        option_index;
    char    ** list;
+   WalkConfig cfg;
+   MyState    state;
 
-   static char   short_options[] = "acfhLqrvV";
+   static char   short_options[] = "0acfHhj:LqrUvVx:";
    static struct option long_options[] =
    {
       {"help",          no_argument, 0, 'h'},
@@ -145,9 +203,14 @@ int main(int argc, char * argv[])
       {NULL,            0,           0, 0  }
    };
 
-   opts         = 0;
    option_index = 0;
    list         = NULL;
+   memset(&cfg, 0, sizeof(cfg));
+   memset(&state, 0, sizeof(state));
+   cfg.jobs     = 1;
+   cfg.data     = &state;
+   cfg.func     = my_entry;
+   state.delim  = '\n';
 
    while((c = getopt_long(argc, argv, short_options, long_options, &option_index)) != -1)
    {
@@ -156,33 +219,63 @@ int main(int argc, char * argv[])
          case -1:       /* no more arguments */
          case 0:        /* long option toggles */
             break;
+         case '0':
+            state.opts |= MY_OPT_NULL | MY_OPT_VERBOSE;
+            state.delim = '\0';
+            break;
          case 'a':
-            opts |= MY_OPT_HIDDEN;
+            state.opts |= MY_OPT_HIDDEN;
+            cfg.opts   |= WALK_OPT_HIDDEN;
             break;
          case 'c':
-            opts |= MY_OPT_CONTINUE;
+            state.opts |= MY_OPT_CONTINUE;
+            cfg.opts   |= WALK_OPT_CONTINUE;
             break;
          case 'f':
-            opts |= MY_OPT_FORCE;
+            state.opts |= MY_OPT_FORCE;
+            break;
+         case 'H':
+            cfg.opts   |= WALK_OPT_HARDLINKS;
             break;
          case 'h':
             my_usage();
             return(0);
+         case 'j':
+            cfg.jobs = (unsigned)strtoul(optarg, NULL, 0);
+            if ( (cfg.jobs < 1) || (cfg.jobs > WALK_JOBS_MAX) )
+            {
+               fprintf(stderr, "%s: number of jobs must be between 1 and %u\n", PROGRAM_NAME, WALK_JOBS_MAX);
+               return(1);
+            };
+            break;
          case 'L':
-            opts |= MY_OPT_LINKS;
+            state.opts |= MY_OPT_LINKS;
+            cfg.opts   |= WALK_OPT_LINKS;
             break;
          case 'q':
-            opts |= MY_OPT_QUIET;
+            state.opts |= MY_OPT_QUIET;
             break;
          case 'r':
-            opts |= MY_OPT_RECURSE;
+            state.opts |= MY_OPT_RECURSE;
+            cfg.opts   |= WALK_OPT_RECURSE;
+            break;
+         case 'U':
+            cfg.opts   |= WALK_OPT_URING;
             break;
          case 'v':
-            opts |= MY_OPT_VERBOSE;
+            state.opts |= MY_OPT_VERBOSE;
             break;
          case 'V':
             my_version();
             return(0);
+         case 'x':
+            if (my_exec_init(&state, optarg))
+            {
+               my_exec_free(&state);
+               return(1);
+            };
+            state.opts |= MY_OPT_EXEC;
+            break;
          case '?':
             fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
             return(1);
@@ -200,17 +293,29 @@ int main(int argc, char * argv[])
       return(1);
    };
 
-   for(i = optind; i < argc; i++)
-      switch (recurse_directory(argv[i], opts, NULL, NULL))
+   if ((state.opts & MY_OPT_VERBOSE))
+      setvbuf(stdout, NULL, _IOFBF, MY_OUTPUT_SIZE);
+
+   rc = 0;
+   for(i = optind; ((i < argc) && (!(rc))); i++)
+      switch (walk_tree(argv[i], &cfg))
       {
-         case -1: return(1);
-         case 0:  break;
+         case -1:
+            rc = -1;
+            break;
+         case 0:
+            break;
          default:
-            if (!(opts & MY_OPT_CONTINUE))
-               return(1);
+            if (!(state.opts & MY_OPT_CONTINUE))
+               rc = 1;
             break;
       };
-   return(0);
+
+   if ( (rc != -1) && (my_exec_run(&state) == -1) )
+      rc = -1;
+   my_exec_free(&state);
+
+   return( ((rc)||(state.status)) ? 1 : 0 );
 }
 
 
@@ -218,15 +323,20 @@ int main(int argc, char * argv[])
 void my_usage(void)
 {
    printf("Usage: %s [OPTIONS] file1 file2 ... fileN\n", PROGRAM_NAME);
+   printf("  -0                        print paths terminated by a null character\n");
    printf("  -a                        include entries whose names begin with a dot (.).\n");
    printf("  -c                        continue on error\n");
    printf("  -f                        force writes\n");
-   printf("  -L                        follow symbolic links\n");
+   printf("  -j jobs                   number of directories to read in parallel\n");
+   printf("  -H                        process files with several links only once\n");
+   printf("  -L                        follow symbolic links, reading each directory once\n");
    printf("  -h, --help                print this help and exit\n");
    printf("  -v, --verbose             print version number and exit\n");
    printf("  -V, --version             print version number and exit\n");
    printf("  -q, --quiet, --silent     do not print messages\n");
    printf("  -r                        recursively follow directories\n");
+   printf("  -U                        retrieve file status in batches using io_uring\n");
+   printf("  -x command                run command with many files as arguments\n");
 #ifdef PACKAGE_BUGREPORT
    printf("\n");
    printf("Report bugs to <%s>.\n", PACKAGE_BUGREPORT);
@@ -250,192 +360,264 @@ void my_version(void)
 }
 
 
-int recurse_directory(char * origin, int opts, void * data,
-   int (*func)(const char * file, int opts, void * data))
+/// prints files and errors found while walking a directory tree
+/// @param[in]  entry    entry found by walk
+/// @param[in]  data     pointer to state of program
+int my_entry(const WalkEntry * entry, void * data)
 {
-   int             err;
-   DIR           * d;
-   char          * file;
-   char         ** queue;
-   void          * ptr;
-   size_t          len_dir;
-   size_t          len_file;
-   unsigned        size;
-   unsigned        count;
-   struct dirent * dp;
-
-   size  = 0;
-   count = 0;
-   ptr   = NULL;
-   queue = NULL;
-
-   // seeds queue with first file/directory
-   if ((err = recurse_file(origin, opts, data, func, &count, &queue, &size)))
-      return(err);
-
-   if (!(opts & MY_OPT_RECURSE))
+   int       opts;
+   int       report;
+   MyState * state;
+
+   state  = data;
+   opts   = state->opts;
+   report = ( ((!(opts & MY_OPT_QUIET))&&(opts & MY_OPT_CONTINUE)) || (!(opts & MY_OPT_CONTINUE)) );
+
+   switch(entry->type)
    {
-      if (queue)
+      case WALK_DIR:
+         if (opts & MY_OPT_VERBOSE)
+            printf("%s%c", entry->path, state->delim);
+         return(0);
+
+      case WALK_FILE:
+         if (opts & MY_OPT_VERBOSE)
+            printf("%s%c", entry->path, state->delim);
+         if (opts & MY_OPT_EXEC)
+            return(my_exec_add(state, entry->path));
+         return(0);
+
+      case WALK_LINK:  // ignore symbolic links
+         return(0);
+
+      case WALK_OTHER:
+         if ((report))
+            fprintf(stderr, "%s: %s: unknown file type\n", PROGRAM_NAME, entry->path);
+         return(1);
+
+      default:
+         if ( ((report)) || (entry->err == ENOMEM) )
+            fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, entry->path, strerror(entry->err));
+         return(1);
+   };
+}
+
+/// queues a file as an argument of the command, running the command first
+/// if the argument would exceed ARG_MAX
+/// @param[in]  state    state of program
+/// @param[in]  path     path of file
+int my_exec_add(MyState * state, const char * path)
+{
+   size_t   len;
+   size_t   size;
+   char  ** argv;
+
+   len = strlen(path) + 1 + sizeof(char *);
+
+   pthread_mutex_lock(&state->lock);
+
+   if ((state->used + len) > state->limit)
+      if (my_exec_run(state) == -1)
       {
-         free(queue[0]);
-         free(queue);
+         pthread_mutex_unlock(&state->lock);
+         return(-1);
       };
-      return(0);
+   if ((state->used + len) > state->limit)
+   {
+      pthread_mutex_unlock(&state->lock);
+      fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, path, strerror(E2BIG));
+      return(1);
    };
 
-   while(count)
+   // leaves room for the terminating NULL
+   if ((state->count + 2) > state->size)
    {
-      if (opts & MY_OPT_VERBOSE)
-         printf("%s\n", queue[count-1]);
-
-      // opens directory for processing
-      if (!(d = opendir(queue[count-1])))
+      size = state->size * 2;
+      if ((argv = realloc(state->argv, sizeof(char *) * size)) == NULL)
       {
-         if ( ((!(opts & MY_OPT_QUIET))&&(opts & MY_OPT_CONTINUE)) || (!(opts & MY_OPT_CONTINUE)) )
-            fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, queue[count-1], strerror(errno));
-         if (!(opts & MY_OPT_CONTINUE))
-            return(1);
+         pthread_mutex_unlock(&state->lock);
+         fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+         return(-1);
       };
+      state->argv = argv;
+      state->size = size;
+   };
+   if ((state->argv[state->count] = strdup(path)) == NULL)
+   {
+      pthread_mutex_unlock(&state->lock);
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      return(-1);
+   };
+   state->count++;
+   state->used += len;
 
-      len_dir = strlen(queue[count-1]);
+   pthread_mutex_unlock(&state->lock);
 
-      for(dp = readdir(d); dp; dp = readdir(d))
-      {
-         len_file = strlen(dp->d_name);
-         if (!(file = malloc(sizeof(char) * (len_dir + len_file + 2))))
-         {
-            fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
-            return(-1);
-         };
-         sprintf(file, "%s/%s", queue[count-1], dp->d_name);
+   return(0);
+}
 
-         if ( (dp->d_name[0] == '.') && (opts & MY_OPT_HIDDEN) )
-         {
-            if ( (dp->d_name[1] != '/') &&
-                 (dp->d_name[1] != '\0') &&
-                 (dp->d_name[1] != '.') )
-            {
-               switch (recurse_file(file, opts, data, func, &count, &queue, &size))
-               {
-                  case -1:
-                     free(file);
-                     closedir(d);
-                     return(1);
-                  case 0:
-                     free(file);
-                     break;
-                  default:
-                     free(file);
-                     if (!(opts & MY_OPT_CONTINUE))
-                     {
-                        closedir(d);
-                        return(1);
-                     };
-                     break;
-               };
-            };
-         }
-         else if (dp->d_name[0] != '.')
-         {
-            switch (recurse_file(file, opts, data, func, &count, &queue, &size))
-            {
-               case -1:
-                  free(file);
-                  closedir(d);
-                  return(1);
-               case 0:
-                  free(file);
-                  break;
-               default:
-                  free(file);
-                  if (!(opts & MY_OPT_CONTINUE))
-                  {
-                     closedir(d);
-                     return(1);
-                  };
-                  break;
-            };
-         };
-      };
 
-      // closes directory and removes from queue
-      closedir(d);
-      count--;
-      free(queue[count]);
-   };
+/// frees resources used to run commands
+/// @param[in]  state    state of program
+void my_exec_free(MyState * state)
+{
+   size_t u;
 
-   free(queue);
+   if (!(state->argv))
+      return;
 
-   return(0);
+   for(u = state->base; u < state->count; u++)
+      free(state->argv[u]);
+   free(state->argv);
+   free(state->command);
+   pthread_mutex_destroy(&state->lock);
+
+   state->argv    = NULL;
+   state->command = NULL;
+   state->opts   &= ~MY_OPT_EXEC;
+
+   return;
 }
 
 
-int recurse_file(const char * file, int opts, void * data,
-   int (*func)(const char * file, int opts, void * data), unsigned * countp,
-   char *** queuep, unsigned * sizep)
+/// splits command into arguments and determines the space available for
+/// file arguments
+/// @param[in]  state    state of program
+/// @param[in]  command  command and initial arguments separated by blanks
+int my_exec_init(MyState * state, const char * command)
 {
-   int             err;
-   void          * ptr;
-   unsigned        u;
-   struct stat     sb;
-
-   if (opts & MY_OPT_LINKS)
-      err = stat(file, &sb);
-   else
-      err = lstat(file, &sb);
-   if (err == -1)
+   long     arg_max;
+   size_t   env;
+   size_t   u;
+   size_t   size;
+   char   * arg;
+   char   * ptr;
+   char  ** argv;
+
+   if ((state->argv))
    {
-      if ( ((!(opts & MY_OPT_QUIET))&&(opts & MY_OPT_CONTINUE)) || (!(opts & MY_OPT_CONTINUE)) )
-         fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, file, strerror(errno));
+      fprintf(stderr, "%s: only one command may be specified\n", PROGRAM_NAME);
       return(1);
    };
-   switch(sb.st_mode & (S_IFDIR|S_IFREG|S_IFLNK))
+
+   if ((arg_max = sysconf(_SC_ARG_MAX)) < _POSIX_ARG_MAX)
+      arg_max = _POSIX_ARG_MAX;
+
+   // the environment is passed to the command along with its arguments
+   env = 0;
+   for(u = 0; ((environ) && (environ[u])); u++)
+      env += strlen(environ[u]) + 1 + sizeof(char *);
+   if ((env + MY_EXEC_MARGIN) >= (size_t)arg_max)
    {
-      case S_IFDIR:
-         // adjust size of array
-         if (*countp >= *sizep)
-         {
-            *sizep += 20;
-            if (!(ptr = realloc(*queuep, sizeof(char *) * (*sizep))))
-            {
-               fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
-               return(-1);
-            };
-            *queuep = ptr;
-         };
+      fprintf(stderr, "%s: environment is too large to run commands\n", PROGRAM_NAME);
+      return(1);
+   };
+   state->limit = (size_t)arg_max - env - MY_EXEC_MARGIN;
 
-         // copy path name
-         if (!(ptr = strdup(file)))
+   pthread_mutex_init(&state->lock, NULL);
+   state->size = 64;
+   if ((state->argv = malloc(sizeof(char *) * state->size)) == NULL)
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      return(1);
+   };
+   if ((state->command = strdup(command)) == NULL)
+   {
+      fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
+      return(1);
+   };
+
+   for(arg = strtok_r(state->command, " \t", &ptr); ((arg)); arg = strtok_r(NULL, " \t", &ptr))
+   {
+      // leaves room for the terminating NULL
+      if ((state->count + 2) > state->size)
+      {
+         size = state->size * 2;
+         if ((argv = realloc(state->argv, sizeof(char *) * size)) == NULL)
          {
             fprintf(stderr, "%s: out of virtual memory\n", PROGRAM_NAME);
-            return(-1);
+            return(1);
          };
+         state->argv = argv;
+         state->size = size;
+      };
+      // initial arguments point into command and are never freed individually
+      state->argv[state->count++] = arg;
+      state->base  = state->count;
+      state->used += strlen(arg) + 1 + sizeof(char *);
+      if (state->used >= state->limit)
+      {
+         fprintf(stderr, "%s: %s\n", PROGRAM_NAME, strerror(E2BIG));
+         return(1);
+      };
+   };
+   if (!(state->count))
+   {
+      fprintf(stderr, "%s: command must not be empty\n", PROGRAM_NAME);
+      return(1);
+   };
 
-         // insert path name at head of array
-         for(u = (*countp); u > 0; u--)
-            (*queuep)[u] = (*queuep)[u-1];
-         (*queuep)[0] = ptr;
-         (*countp)++;
-         break;
+   state->used_base = state->used;
 
-      case S_IFLNK:  // ignore symbolic links
-         break;
+   return(0);
+}
 
-      case S_IFREG:
-         if (opts & MY_OPT_VERBOSE)
-            printf("%s\n", file);
-         if (func)
-            return(func(file, opts, data));
-         break;
 
-      default:
-         if ( ((!(opts & MY_OPT_QUIET))&&(opts & MY_OPT_CONTINUE)) || (!(opts & MY_OPT_CONTINUE)) )
-            fprintf(stderr, "%s: %s: unknown file type\n", PROGRAM_NAME, file);
-         return(1);
-         break;
+/// runs the command with the queued files and waits for it to exit
+/// @param[in]  state    state of program
+int my_exec_run(MyState * state)
+{
+   int      status;
+   pid_t    pid;
+   size_t   u;
+
+   if ( (!(state->opts & MY_OPT_EXEC)) || (state->count == state->base) )
+      return(0);
+
+   state->argv[state->count] = NULL;
+
+   // keeps listed paths ahead of the output of the command
+   fflush(stdout);
+
+   if ((pid = fork()) == -1)
+   {
+      fprintf(stderr, "%s: fork(): %s\n", PROGRAM_NAME, strerror(errno));
+      return(-1);
+   };
+   if (pid == 0)
+   {
+      // other threads may hold the lock of stderr, so stdio is not used
+      execvp(state->argv[0], state->argv);
+      if (write(STDERR_FILENO, PROGRAM_NAME ": ", strlen(PROGRAM_NAME ": ")) != -1)
+         if (write(STDERR_FILENO, state->argv[0], strlen(state->argv[0])) != -1)
+            if (write(STDERR_FILENO, ": unable to execute\n", 20) == -1)
+               _exit(127);
+      _exit(127);
    };
 
+   for(u = state->base; u < state->count; u++)
+      free(state->argv[u]);
+   state->count = state->base;
+   state->used  = state->used_base;
+
+   while (waitpid(pid, &status, 0) == -1)
+   {
+      if (errno != EINTR)
+      {
+         fprintf(stderr, "%s: waitpid(): %s\n", PROGRAM_NAME, strerror(errno));
+         return(-1);
+      };
+   };
+
+   if ( (WIFEXITED(status)) && (!(WEXITSTATUS(status))) )
+      return(0);
+   state->status = 1;
+   if ( (WIFEXITED(status)) && (WEXITSTATUS(status) == 127) )
+      return(-1);
+   if ((WIFSIGNALED(status)))
+      fprintf(stderr, "%s: %s: terminated by signal %d\n", PROGRAM_NAME, state->argv[0], WTERMSIG(status));
    return(0);
 }
 
+
 // end of source code
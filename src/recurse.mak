@@ -1,7 +1,8 @@
-recurse: Makefile recurse.c recurse.mak
+recurse: Makefile recurse.c walk.c walk.h recurse.mak
 	$(LIBTOOL) --mode=compile --tag=CC $(CC) $(CFLAGS) -c recurse.c
-	$(LIBTOOL) --mode=link    --tag=CC $(CC) $(CFLAGS) -o recurse recurse.lo
+	$(LIBTOOL) --mode=compile --tag=CC $(CC) $(CFLAGS) -c walk.c
+	$(LIBTOOL) --mode=link    --tag=CC $(CC) $(CFLAGS) -o recurse recurse.lo walk.lo -lpthread
 
 recurse-clean:
-	$(LIBTOOL) --mode=clean rm -f recurse.lo recurse
+	$(LIBTOOL) --mode=clean rm -f recurse.lo walk.lo recurse
 
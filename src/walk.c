@@ -0,0 +1,1230 @@
+/*
+ *  DMS Tools and Utilities
+ *  Copyright (C) 2008 David M. Syzdek <david@syzdek.net>.
+ *
+ *  @SYZDEK_LICENSE_HEADER_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of David M. Syzdek nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DAVID M. SYZDEK BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @SYZDEK_LICENSE_HEADER_END@
+ */
+/**
+ *  @file src/walk.c  directory tree walking library
+ */
+#define _DMSTOOLS_SRC_WALK_C 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+
+#ifdef HAVE_COMMON_H
+#include "common.h"
+#endif
+#include "walk.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+
+#ifdef HAVE_IORING_OP_STATX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <linux/stat.h>
+#include <linux/io_uring.h>
+#endif
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+
+#if defined(HAVE_IORING_OP_STATX) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define WALK_URING 1
+#endif
+
+#define WALK_URING_DEPTH     64
+#define WALK_INODE_LOCKS     64
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+
+typedef struct walk_inode  WalkInode;
+typedef struct walk_inodes WalkInodes;
+typedef struct walk_queue  WalkQueue;
+typedef struct walk_state  WalkState;
+typedef struct walk_uring  WalkUring;
+
+
+///////////////
+//           //
+//  Structs  //
+//           //
+///////////////
+
+/// device and inode numbers identifying a file
+struct walk_inode
+{
+   dev_t                dev;        ///< device containing file
+   ino_t                ino;        ///< inode number of file
+   int                  used;       ///< set if slot is in use
+   int                  pad;
+};
+
+
+/// stripe of a set of visited files
+///
+/// Each set is split into WALK_INODE_LOCKS independently locked hash tables
+/// so that workers rarely contend for the same lock.
+struct walk_inodes
+{
+   pthread_mutex_t      lock;       ///< protects the hash table
+   WalkInode          * list;       ///< open addressed hash table
+   size_t               count;      ///< number of files in table
+   size_t               size;       ///< capacity of table, a power of two
+};
+
+
+/// directories waiting to be read by a single worker
+///
+/// The owning worker removes directories from the front of the ring, idle
+/// workers steal from the back.
+struct walk_queue
+{
+   pthread_mutex_t      lock;       ///< protects the ring
+   pthread_t            thread;     ///< thread of worker owning the queue
+   WalkState          * walk;       ///< walk the queue belongs to
+   char              ** list;       ///< ring of directory names
+   size_t               head;       ///< index of first directory in ring
+   size_t               count;      ///< number of directories in ring
+   size_t               size;       ///< capacity of ring
+   char               * path;       ///< buffer reused to build entry paths
+   size_t               path_size;  ///< capacity of path buffer
+   WalkUring          * uring;      ///< io_uring of worker, NULL if not used
+};
+
+
+/// state shared by the workers of a directory walk
+struct walk_state
+{
+   const WalkConfig   * cfg;        ///< options and callbacks of walk
+   int                  err;        ///< error which stopped the walk
+   int                  stop;       ///< set when workers should exit
+   unsigned             jobs;       ///< number of workers
+   unsigned             idle;       ///< number of workers waiting for work
+   size_t               pending;    ///< directories queued or being read
+   size_t               pushes;     ///< directories queued since start of walk
+   pthread_mutex_t      lock;       ///< protects the counters above
+   pthread_cond_t       cond;       ///< signals new work or end of walk
+   WalkQueue            queues[WALK_JOBS_MAX];
+   WalkInodes           dirs[WALK_INODE_LOCKS];   ///< directories already read
+   WalkInodes           files[WALK_INODE_LOCKS];  ///< files with several links already processed
+};
+
+
+#ifdef WALK_URING
+/// io_uring used by a worker to retrieve file status in batches
+struct walk_uring
+{
+   int                  fd;         ///< io_uring file descriptor
+   unsigned           * sq_head;    ///< head of submission queue
+   unsigned           * sq_tail;    ///< tail of submission queue
+   unsigned           * sq_mask;    ///< index mask of submission queue
+   unsigned           * sq_array;   ///< indexes of submission queue entries
+   unsigned           * cq_head;    ///< head of completion queue
+   unsigned           * cq_tail;    ///< tail of completion queue
+   unsigned           * cq_mask;    ///< index mask of completion queue
+   struct io_uring_sqe* sqes;       ///< submission queue entries
+   struct io_uring_cqe* cqes;       ///< completion queue entries
+   void               * sq_ptr;     ///< mapping of submission queue
+   size_t               sq_len;     ///< length of submission queue mapping
+   void               * cq_ptr;     ///< mapping of completion queue
+   size_t               cq_len;     ///< length of completion queue mapping
+   size_t               sqes_len;   ///< length of submission entries mapping
+   size_t               count;      ///< number of entries waiting in batch
+   size_t               inflight;   ///< number of submitted requests not yet reaped
+   size_t               names_len;  ///< bytes used in names buffer
+   size_t               names_size; ///< capacity of names buffer
+   char               * names;      ///< names of entries waiting in batch
+   size_t               off[WALK_URING_DEPTH];  ///< offsets of names
+   int                  res[WALK_URING_DEPTH];  ///< results of statx requests
+   struct statx         stx[WALK_URING_DEPTH];  ///< status of entries
+};
+#endif
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+
+// records an error and stops the walk unless errors are ignored
+int walk_error PARAMS((WalkState * walk, int err));
+
+// marks a directory as read and wakes idle workers at the end of the walk
+void walk_finish PARAMS((WalkState * walk));
+
+// ensures a queue has room for additional directories
+int walk_grow PARAMS((WalkQueue * queue, size_t n));
+
+// computes hash of device and inode numbers
+uint64_t walk_hash PARAMS((dev_t dev, ino_t ino));
+
+// queues directories or passes files to callback based upon file type
+int walk_mode PARAMS((WalkState * walk, WalkQueue * queue, const char * path,
+   const char * name, mode_t mode, const struct stat * sb));
+
+// appends a directory to the back of a worker's queue
+int walk_push PARAMS((WalkState * walk, WalkQueue * queue, char * dir));
+
+// reads a directory and processes each entry
+int walk_read PARAMS((WalkState * walk, WalkQueue * queue, const char * dir));
+
+// appends an entry name to the directory name in a worker's path buffer
+int walk_path PARAMS((WalkQueue * queue, size_t len_dir, const char * name));
+
+// passes an error or directory to the callback
+int walk_report PARAMS((WalkState * walk, int type, const char * path,
+   mode_t mode, int err));
+
+// retrieves status of an entry relative to a directory and processes entry
+int walk_stat PARAMS((WalkState * walk, WalkQueue * queue, int fd,
+   size_t len_dir, const char * name));
+
+// removes a directory from the front of a queue
+char * walk_shift PARAMS((WalkQueue * queue));
+
+// moves half of the directories of another worker's queue into a queue
+char * walk_steal PARAMS((WalkState * walk, WalkQueue * queue));
+
+// returns the next directory for a worker, waiting for work if needed
+char * walk_take PARAMS((WalkState * walk, WalkQueue * queue));
+
+#ifdef WALK_URING
+// queues an entry for a batched statx request
+int walk_uring_add PARAMS((WalkState * walk, WalkQueue * queue, int fd,
+   size_t len_dir, const char * name));
+
+// submits batched statx requests and processes the entries
+int walk_uring_flush PARAMS((WalkState * walk, WalkQueue * queue, int fd,
+   size_t len_dir));
+
+// releases io_uring of a worker
+void walk_uring_free PARAMS((WalkQueue * queue));
+
+// creates io_uring for a worker
+int walk_uring_init PARAMS((WalkQueue * queue));
+
+// converts statx results into stat data
+void walk_uring_stat PARAMS((const struct statx * stx, struct stat * sb));
+#endif
+
+// records a file as visited and reports if it was visited before
+int walk_visit PARAMS((WalkInodes * set, dev_t dev, ino_t ino));
+
+// reads directories until the walk is complete
+void * walk_worker PARAMS((void * arg));
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+
+/// records an error and stops the walk unless errors are ignored
+/// @param[in]  walk     state of directory walk
+/// @param[in]  err      error code, -1 for fatal errors
+int walk_error(WalkState * walk, int err)
+{
+   if ( (!(err)) || ( (err != -1) && ((walk->cfg->opts & WALK_OPT_CONTINUE)) ) )
+      return(0);
+   pthread_mutex_lock(&walk->lock);
+   if (!(walk->err))
+      walk->err = err;
+   walk->stop = 1;
+   pthread_cond_broadcast(&walk->cond);
+   pthread_mutex_unlock(&walk->lock);
+   return(err);
+}
+
+
+/// marks a directory as read and wakes idle workers at the end of the walk
+/// @param[in]  walk     state of directory walk
+void walk_finish(WalkState * walk)
+{
+   pthread_mutex_lock(&walk->lock);
+   walk->pending--;
+   if (!(walk->pending))
+      pthread_cond_broadcast(&walk->cond);
+   pthread_mutex_unlock(&walk->lock);
+   return;
+}
+
+
+/// ensures a queue has room for additional directories
+///
+/// The caller must hold the lock of the queue.
+///
+/// @param[in]  queue    queue to grow
+/// @param[in]  n        number of directories to make room for
+int walk_grow(WalkQueue * queue, size_t n)
+{
+   size_t          u;
+   size_t          size;
+   char         ** list;
+
+   if ((queue->count + n) <= queue->size)
+      return(0);
+
+   for(size = ((queue->size)) ? queue->size : 32; size < (queue->count + n); size *= 2);
+   if (!(list = realloc(queue->list, sizeof(char *) * size)))
+      return(-1);
+
+   // moves entries which wrapped around to follow the old end of the ring
+   for(u = 0; (queue->size + u) < (queue->head + queue->count); u++)
+      list[queue->size + u] = list[u];
+
+   queue->list = list;
+   queue->size = size;
+
+   return(0);
+}
+
+
+/// computes hash of device and inode numbers
+/// @param[in]  dev      device containing file
+/// @param[in]  ino      inode number of file
+uint64_t walk_hash(dev_t dev, ino_t ino)
+{
+   uint64_t hash;
+   hash  = ((uint64_t)ino * 0x9e3779b97f4a7c15ULL) ^ ((uint64_t)dev * 0xc2b2ae3d27d4eb4fULL);
+   hash ^= hash >> 29;
+   return(hash);
+}
+
+
+/// queues directories or passes files to callback based upon file type
+/// @param[in]  walk     state of directory walk
+/// @param[in]  queue    queue of calling worker
+/// @param[in]  path     path of entry
+/// @param[in]  name     last component of path, NULL for the origin of the walk
+/// @param[in]  mode     file type as returned in st_mode by stat()
+/// @param[in]  sb       stat data of entry, NULL if not retrieved
+int walk_mode(WalkState * walk, WalkQueue * queue, const char * path,
+   const char * name, mode_t mode, const struct stat * sb)
+{
+   char          * dir;
+   WalkEntry       entry;
+
+   entry.err  = 0;
+   entry.mode = mode & S_IFMT;
+   entry.path = path;
+   entry.name = name;
+   entry.sb   = sb;
+   if (!(name))
+      entry.name = ((entry.name = strrchr(path, '/'))) ? &entry.name[1] : path;
+   switch(entry.mode)
+   {
+      case S_IFDIR:  entry.type = WALK_DIR;   break;
+      case S_IFREG:  entry.type = WALK_FILE;  break;
+      case S_IFLNK:  entry.type = WALK_LINK;  break;
+      default:       entry.type = WALK_OTHER; break;
+   };
+
+   // entries below the origin may be filtered
+   if ( ((walk->cfg->filter)) && ((name)) )
+      if ((walk->cfg->filter(&entry, walk->cfg->data)))
+         return(0);
+
+   if (entry.type == WALK_DIR)
+   {
+      if (!(walk->cfg->opts & WALK_OPT_RECURSE))
+         return(0);
+      if (!(dir = strdup(path)))
+         return(walk_report(walk, WALK_ERROR, path, mode, ENOMEM));
+      return(walk_push(walk, queue, dir));
+   };
+
+   // skips files which were already processed through another link, files
+   // reached through symbolic links may have a single link
+   if ( (entry.type == WALK_FILE) && ((sb)) && ((walk->cfg->opts & WALK_OPT_HARDLINKS)) &&
+        ( (sb->st_nlink > 1) || ((walk->cfg->opts & WALK_OPT_LINKS)) ) )
+   {
+      switch(walk_visit(walk->files, sb->st_dev, sb->st_ino))
+      {
+         case 0:  break;
+         case 1:  return(0);
+         default: return(walk_report(walk, WALK_ERROR, path, mode, ENOMEM));
+      };
+   };
+
+   return(walk->cfg->func(&entry, walk->cfg->data));
+}
+
+
+/// appends a directory to the back of a worker's queue
+/// @param[in]  walk     state of directory walk
+/// @param[in]  queue    queue of calling worker
+/// @param[in]  dir      allocated directory name, owned by queue on success
+int walk_push(WalkState * walk, WalkQueue * queue, char * dir)
+{
+   pthread_mutex_lock(&queue->lock);
+   if ((walk_grow(queue, 1)))
+   {
+      pthread_mutex_unlock(&queue->lock);
+      walk_report(walk, WALK_ERROR, dir, S_IFDIR, ENOMEM);
+      free(dir);
+      return(-1);
+   };
+   queue->list[(queue->head + queue->count) % queue->size] = dir;
+   queue->count++;
+   pthread_mutex_unlock(&queue->lock);
+
+   pthread_mutex_lock(&walk->lock);
+   walk->pending++;
+   walk->pushes++;
+   if ((walk->idle))
+      pthread_cond_signal(&walk->cond);
+   pthread_mutex_unlock(&walk->lock);
+
+   return(0);
+}
+
+
+/// reads a directory and processes each entry
+///
+/// Entries are classified using the type returned by readdir() when the
+/// platform provides one and with fstatat() relative to the open directory
+/// otherwise, so most entries are processed without a stat call. Entry paths
+/// are built in a buffer owned by the worker instead of being allocated.
+///
+/// @param[in]  walk     state of directory walk
+/// @param[in]  queue    queue of calling worker
+/// @param[in]  dir      path of directory to read
+int walk_read(WalkState * walk, WalkQueue * queue, const char * dir)
+{
+   int             fd;
+   int             err;
+   int             opts;
+   DIR           * d;
+   char          * ptr;
+   size_t          len_dir;
+   size_t          size;
+   mode_t          mode;
+   struct stat     sb;
+   struct dirent * dp;
+
+   opts = walk->cfg->opts;
+
+   // opens directory for processing
+   d = NULL;
+   if ((fd = open(dir, O_RDONLY|O_DIRECTORY|O_CLOEXEC)) != -1)
+      if (!(d = fdopendir(fd)))
+         close(fd);
+   err = errno;
+
+   // skips directories which were already read when following symbolic
+   // links, which also prevents loops
+   if ( ((d)) && ((opts & WALK_OPT_LINKS)) && (!(fstat(fd, &sb))) )
+   {
+      switch(walk_visit(walk->dirs, sb.st_dev, sb.st_ino))
+      {
+         case 0:
+            break;
+         case 1:
+            closedir(d);
+            return(0);
+         default:
+            closedir(d);
+            return(walk_report(walk, WALK_ERROR, dir, S_IFDIR, ENOMEM));
+      };
+   };
+
+   if ((err = walk_report(walk, WALK_DIR, dir, S_IFDIR, 0)))
+   {
+      if ((d))
+         closedir(d);
+      return(err);
+   };
+   if (!(d))
+      return(walk_report(walk, WALK_ERROR, dir, S_IFDIR, err));
+
+   // copies directory name into path buffer
+   len_dir = strlen(dir);
+   if ((size = len_dir + 2 + 256) > queue->path_size)
+   {
+      if (!(ptr = realloc(queue->path, size)))
+      {
+         closedir(d);
+         return(walk_report(walk, WALK_ERROR, dir, S_IFDIR, ENOMEM));
+      };
+      queue->path      = ptr;
+      queue->path_size = size;
+   };
+   memcpy(queue->path, dir, len_dir);
+   queue->path[len_dir++] = '/';
+#ifdef WALK_URING
+   if ((queue->uring))
+   {
+      queue->uring->count     = 0;
+      queue->uring->names_len = 0;
+   };
+#endif
+
+   for(dp = readdir(d); dp; dp = readdir(d))
+   {
+      // skips current and parent directories and, unless requested, hidden entries
+      if (dp->d_name[0] == '.')
+      {
+         if (!(opts & WALK_OPT_HIDDEN))
+            continue;
+         if ( (dp->d_name[1] == '\0') ||
+              ( (dp->d_name[1] == '.') && (dp->d_name[2] == '\0') ) )
+            continue;
+      };
+
+      // determines file type without stat() when possible
+      mode = 0;
+#ifdef DT_UNKNOWN
+      switch(dp->d_type)
+      {
+         case DT_DIR: mode = S_IFDIR; break;
+         case DT_REG: mode = (opts & (WALK_OPT_STAT|WALK_OPT_HARDLINKS)) ? 0 : S_IFREG; break;
+         case DT_LNK: mode = (opts & WALK_OPT_LINKS) ? 0 : S_IFLNK; break;
+         default:     break;
+      };
+#endif
+      if ((mode))
+      {
+         if ((walk_path(queue, len_dir, dp->d_name)))
+            err = walk_report(walk, WALK_ERROR, dir, S_IFDIR, ENOMEM);
+         else
+            err = walk_mode(walk, queue, queue->path, &queue->path[len_dir], mode, NULL);
+      }
+#ifdef WALK_URING
+      else if ((queue->uring))
+         err = walk_uring_add(walk, queue, fd, len_dir, dp->d_name);
+#endif
+      else
+         err = walk_stat(walk, queue, fd, len_dir, dp->d_name);
+      if ((walk_error(walk, err)))
+      {
+         closedir(d);
+         return(err);
+      };
+   };
+
+#ifdef WALK_URING
+   // processes entries remaining in batch
+   if ((queue->uring))
+   {
+      err = walk_uring_flush(walk, queue, fd, len_dir);
+      if ((walk_error(walk, err)))
+      {
+         closedir(d);
+         return(err);
+      };
+   };
+#endif
+
+   // closes directory
+   closedir(d);
+
+   return(0);
+}
+
+
+/// appends an entry name to the directory name in a worker's path buffer
+/// @param[in]  queue    queue of calling worker
+/// @param[in]  len_dir  length of directory name including trailing slash
+/// @param[in]  name     name of entry
+int walk_path(WalkQueue * queue, size_t len_dir, const char * name)
+{
+   char          * ptr;
+   size_t          len;
+
+   len = strlen(name);
+   if ((len_dir + len + 1) > queue->path_size)
+   {
+      if (!(ptr = realloc(queue->path, len_dir + len + 1)))
+         return(-1);
+      queue->path      = ptr;
+      queue->path_size = len_dir + len + 1;
+   };
+   memcpy(&queue->path[len_dir], name, len + 1);
+
+   return(0);
+}
+
+
+/// passes an error or directory to the callback
+/// @param[in]  walk     state of directory walk
+/// @param[in]  type     WALK_ERROR or WALK_DIR
+/// @param[in]  path     path of entry
+/// @param[in]  mode     file type of entry, 0 if unknown
+/// @param[in]  err      errno value of error
+int walk_report(WalkState * walk, int type, const char * path,
+   mode_t mode, int err)
+{
+   int             rc;
+   WalkEntry       entry;
+
+   entry.type = type;
+   entry.err  = err;
+   entry.mode = mode;
+   entry.path = path;
+   entry.name = ((entry.name = strrchr(path, '/'))) ? &entry.name[1] : path;
+   entry.sb   = NULL;
+
+   rc = walk->cfg->func(&entry, walk->cfg->data);
+
+   // errors are reported as failures even if the callback ignores them
+   if (type != WALK_ERROR)
+      return(rc);
+   if (err == ENOMEM)
+      return(-1);
+   return(((rc)) ? rc : 1);
+}
+
+
+/// retrieves status of an entry relative to a directory and processes entry
+/// @param[in]  walk     state of directory walk
+/// @param[in]  queue    queue of calling worker
+/// @param[in]  fd       file descriptor of directory
+/// @param[in]  len_dir  length of directory name including trailing slash
+/// @param[in]  name     name of entry
+int walk_stat(WalkState * walk, WalkQueue * queue, int fd, size_t len_dir,
+   const char * name)
+{
+   struct stat     sb;
+
+   if ((walk_path(queue, len_dir, name)))
+   {
+      queue->path[len_dir - 1] = '\0';
+      return(walk_report(walk, WALK_ERROR, queue->path, S_IFDIR, ENOMEM));
+   };
+   if ((fstatat(fd, name, &sb, (walk->cfg->opts & WALK_OPT_LINKS) ? 0 : AT_SYMLINK_NOFOLLOW)))
+      return(walk_report(walk, WALK_ERROR, queue->path, 0, errno));
+   return(walk_mode(walk, queue, queue->path, &queue->path[len_dir], sb.st_mode, &sb));
+}
+
+
+/// removes a directory from the front of a queue
+/// @param[in]  queue    queue to remove directory from
+char * walk_shift(WalkQueue * queue)
+{
+   char          * dir;
+
+   pthread_mutex_lock(&queue->lock);
+   if (!(queue->count))
+   {
+      pthread_mutex_unlock(&queue->lock);
+      return(NULL);
+   };
+   dir         = queue->list[queue->head];
+   queue->head = (queue->head + 1) % queue->size;
+   queue->count--;
+   pthread_mutex_unlock(&queue->lock);
+
+   return(dir);
+}
+
+
+/// moves half of the directories of another worker's queue into a queue
+/// @param[in]  walk     state of directory walk
+/// @param[in]  queue    queue of calling worker
+char * walk_steal(WalkState * walk, WalkQueue * queue)
+{
+   size_t          u;
+   size_t          n;
+   size_t          pos;
+   unsigned        job;
+   WalkQueue     * victim;
+   char          * dir;
+
+   for(job = 1; job < walk->jobs; job++)
+   {
+      victim = &walk->queues[((unsigned)(queue - walk->queues) + job) % walk->jobs];
+
+      // takes the newest half of the victim's directories, the queues are
+      // always locked in the same order to avoid deadlocks
+      if (victim < queue)
+      {
+         pthread_mutex_lock(&victim->lock);
+         pthread_mutex_lock(&queue->lock);
+      } else {
+         pthread_mutex_lock(&queue->lock);
+         pthread_mutex_lock(&victim->lock);
+      };
+      n = (victim->count + 1) / 2;
+      if ( (!(n)) || ((walk_grow(queue, n - 1))) )
+      {
+         pthread_mutex_unlock(&victim->lock);
+         pthread_mutex_unlock(&queue->lock);
+         continue;
+      };
+      pos = victim->head + victim->count - n;
+      dir = victim->list[pos % victim->size];
+      for(u = 1; u < n; u++)
+      {
+         queue->list[(queue->head + queue->count) % queue->size] = victim->list[(pos + u) % victim->size];
+         queue->count++;
+      };
+      victim->count -= n;
+      pthread_mutex_unlock(&victim->lock);
+      pthread_mutex_unlock(&queue->lock);
+
+      return(dir);
+   };
+
+   return(NULL);
+}
+
+
+/// returns the next directory for a worker, waiting for work if needed
+/// @param[in]  walk     state of directory walk
+/// @param[in]  queue    queue of calling worker
+char * walk_take(WalkState * walk, WalkQueue * queue)
+{
+   int             stop;
+   char          * dir;
+   size_t          pushes;
+
+   for(;;)
+   {
+      pthread_mutex_lock(&walk->lock);
+      stop   = walk->stop;
+      pushes = walk->pushes;
+      pthread_mutex_unlock(&walk->lock);
+      if ((stop))
+         return(NULL);
+
+      if ((dir = walk_shift(queue)))
+         return(dir);
+      if ((dir = walk_steal(walk, queue)))
+         return(dir);
+
+      // waits unless directories were queued while searching or the walk
+      // has finished
+      pthread_mutex_lock(&walk->lock);
+      if ( (walk->pushes == pushes) && ((walk->pending)) && (!(walk->stop)) )
+      {
+         walk->idle++;
+         pthread_cond_wait(&walk->cond, &walk->lock);
+         walk->idle--;
+      };
+      if ( (!(walk->pending)) || ((walk->stop)) )
+      {
+         pthread_mutex_unlock(&walk->lock);
+         return(NULL);
+      };
+      pthread_mutex_unlock(&walk->lock);
+   };
+}
+
+
+/// walks a file or directory tree and passes each entry to a callback
+///
+/// Each worker reads directories from its own queue and steals half of the
+/// queue of another worker when its own is empty. The calling thread acts
+/// as the first worker.
+///
+/// @param[in]  origin   file or directory to walk
+/// @param[in]  cfg      options and callbacks of walk
+int walk_tree(const char * origin, const WalkConfig * cfg)
+{
+   int             err;
+   unsigned        u;
+   unsigned        started;
+   WalkState     * walk;
+   WalkQueue     * queue;
+   char          * dir;
+   struct stat     sb;
+
+   if (!(walk = calloc(1, sizeof(WalkState))))
+      return(-1);
+   walk->cfg  = cfg;
+   walk->jobs = ((cfg->jobs)) ? cfg->jobs : 1;
+   walk->jobs = (walk->jobs < WALK_JOBS_MAX) ? walk->jobs : WALK_JOBS_MAX;
+   pthread_mutex_init(&walk->lock, NULL);
+   pthread_cond_init(&walk->cond, NULL);
+   for(u = 0; u < walk->jobs; u++)
+   {
+      walk->queues[u].walk = walk;
+      pthread_mutex_init(&walk->queues[u].lock, NULL);
+   };
+   for(u = 0; u < WALK_INODE_LOCKS; u++)
+   {
+      pthread_mutex_init(&walk->dirs[u].lock, NULL);
+      pthread_mutex_init(&walk->files[u].lock, NULL);
+   };
+
+   // seeds queue with first file/directory, which is always descended
+   if ((cfg->opts & WALK_OPT_LINKS))
+      err = stat(origin, &sb);
+   else
+      err = lstat(origin, &sb);
+   if (err == -1)
+      err = walk_report(walk, WALK_ERROR, origin, 0, errno);
+   else if (S_ISDIR(sb.st_mode))
+      err = ((dir = strdup(origin))) ? walk_push(walk, &walk->queues[0], dir) : walk_report(walk, WALK_ERROR, origin, S_IFDIR, ENOMEM);
+   else
+      err = walk_mode(walk, &walk->queues[0], origin, NULL, sb.st_mode, &sb);
+
+   // starts workers
+   started = 1;
+   if ( (!(err)) && ((cfg->opts & WALK_OPT_RECURSE)) )
+   {
+      for(started = 1; started < walk->jobs; started++)
+         if ((pthread_create(&walk->queues[started].thread, NULL, walk_worker, &walk->queues[started])))
+            break;
+      walk_worker(&walk->queues[0]);
+      err = walk->err;
+   };
+   for(u = 1; u < started; u++)
+      pthread_join(walk->queues[u].thread, NULL);
+
+   // frees directories left after an error or when not recursing
+   for(u = 0; u < walk->jobs; u++)
+   {
+      queue = &walk->queues[u];
+      while((dir = walk_shift(queue)))
+         free(dir);
+      free(queue->list);
+      free(queue->path);
+#ifdef WALK_URING
+      walk_uring_free(queue);
+#endif
+      pthread_mutex_destroy(&queue->lock);
+   };
+   for(u = 0; u < WALK_INODE_LOCKS; u++)
+   {
+      free(walk->dirs[u].list);
+      free(walk->files[u].list);
+      pthread_mutex_destroy(&walk->dirs[u].lock);
+      pthread_mutex_destroy(&walk->files[u].lock);
+   };
+   pthread_cond_destroy(&walk->cond);
+   pthread_mutex_destroy(&walk->lock);
+   free(walk);
+
+   return(err);
+}
+
+
+#ifdef WALK_URING
+/// queues an entry for a batched statx request
+///
+/// The name is copied because readdir() may reuse its buffer before the
+/// batch is submitted.
+///
+/// @param[in]  walk     state of directory walk
+/// @param[in]  queue    queue of calling worker
+/// @param[in]  fd       file descriptor of directory
+/// @param[in]  len_dir  length of directory name including trailing slash
+/// @param[in]  name     name of entry
+int walk_uring_add(WalkState * walk, WalkQueue * queue, int fd,
+   size_t len_dir, const char * name)
+{
+   size_t          len;
+   size_t          size;
+   char          * ptr;
+   WalkUring     * ring;
+
+   ring = queue->uring;
+   len  = strlen(name) + 1;
+
+   if ((ring->names_len + len) > ring->names_size)
+   {
+      size = ((ring->names_size)) ? ring->names_size : 4096;
+      while(size < (ring->names_len + len))
+         size *= 2;
+      if (!(ptr = realloc(ring->names, size)))
+         return(walk_stat(walk, queue, fd, len_dir, name));
+      ring->names      = ptr;
+      ring->names_size = size;
+   };
+   memcpy(&ring->names[ring->names_len], name, len);
+   ring->off[ring->count++]  = ring->names_len;
+   ring->names_len          += len;
+
+   if (ring->count < WALK_URING_DEPTH)
+      return(0);
+   return(walk_uring_flush(walk, queue, fd, len_dir));
+}
+
+
+/// submits batched statx requests and processes the entries
+///
+/// Entries whose requests fail are retried with fstatat() so that kernels
+/// without IORING_OP_STATX and transient errors are handled by the
+/// synchronous path.
+///
+/// @param[in]  walk     state of directory walk
+/// @param[in]  queue    queue of calling worker
+/// @param[in]  fd       file descriptor of directory
+/// @param[in]  len_dir  length of directory name including trailing slash
+int walk_uring_flush(WalkState * walk, WalkQueue * queue, int fd,
+   size_t len_dir)
+{
+   int                   err;
+   long                  rc;
+   size_t                u;
+   size_t                count;
+   size_t                reaped;
+   size_t                submitted;
+   unsigned              tail;
+   unsigned              head;
+   unsigned              index;
+   struct stat           sb;
+   struct io_uring_sqe * sqe;
+   struct io_uring_cqe * cqe;
+   WalkUring           * ring;
+
+   ring        = queue->uring;
+   count       = ring->count;
+   ring->count = 0;
+   if (!(count))
+      return(0);
+
+   // fills submission queue
+   tail = *ring->sq_tail;
+   for(u = 0; u < count; u++)
+   {
+      index = tail & *ring->sq_mask;
+      sqe   = &ring->sqes[index];
+      memset(sqe, 0, sizeof(struct io_uring_sqe));
+      sqe->opcode      = IORING_OP_STATX;
+      sqe->fd          = fd;
+      sqe->addr        = (uint64_t)(uintptr_t)&ring->names[ring->off[u]];
+      sqe->len         = STATX_BASIC_STATS;
+      sqe->off         = (uint64_t)(uintptr_t)&ring->stx[u];
+      sqe->statx_flags = (walk->cfg->opts & WALK_OPT_LINKS) ? 0 : AT_SYMLINK_NOFOLLOW;
+      sqe->user_data   = u;
+      ring->sq_array[index] = index;
+      ring->res[u]     = -EAGAIN;
+      tail++;
+   };
+   __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+   // submits requests, the kernel may consume fewer entries than queued
+   for(submitted = 0; (submitted < count); )
+   {
+      rc = syscall(__NR_io_uring_enter, ring->fd, (unsigned)(count - submitted), 0, 0, NULL, 0);
+      if ( (rc == -1) && (errno == EINTR) )
+         continue;
+      if (rc <= 0)
+         break;
+      submitted += (size_t)rc;
+   };
+   ring->inflight = submitted;
+
+   // waits for completions of submitted requests
+   reaped = 0;
+   while(reaped < submitted)
+   {
+      head = *ring->cq_head;
+      if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+      {
+         if ( (syscall(__NR_io_uring_enter, ring->fd, 0, (unsigned)(submitted - reaped), IORING_ENTER_GETEVENTS, NULL, 0) == -1) &&
+              (errno != EINTR) )
+            break;
+         continue;
+      };
+      cqe = &ring->cqes[head & *ring->cq_mask];
+      if (cqe->user_data < count)
+         ring->res[cqe->user_data] = cqe->res;
+      __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+      reaped++;
+      ring->inflight--;
+   };
+
+   // processes entries, entries without a result are retried with fstatat()
+   err = 0;
+   for(u = 0; ((u < count) && (!(err))); u++)
+   {
+      if (ring->res[u] < 0)
+      {
+         err = walk_error(walk, walk_stat(walk, queue, fd, len_dir, &ring->names[ring->off[u]]));
+         continue;
+      };
+      if ((walk_path(queue, len_dir, &ring->names[ring->off[u]])))
+      {
+         queue->path[len_dir - 1] = '\0';
+         err = walk_error(walk, walk_report(walk, WALK_ERROR, queue->path, S_IFDIR, ENOMEM));
+         continue;
+      };
+      walk_uring_stat(&ring->stx[u], &sb);
+      err = walk_error(walk, walk_mode(walk, queue, queue->path, &queue->path[len_dir], sb.st_mode, &sb));
+   };
+   ring->names_len = 0;
+
+   // a ring which cannot submit or complete its requests is abandoned
+   if ( (submitted < count) || (reaped < submitted) )
+      walk_uring_free(queue);
+
+   return(err);
+}
+
+
+/// releases io_uring of a worker
+/// @param[in]  queue    queue of worker
+void walk_uring_free(WalkQueue * queue)
+{
+   WalkUring     * ring;
+
+   if (!(ring = queue->uring))
+      return;
+   queue->uring = NULL;
+
+   // reaps requests still in flight before unmapping the ring and freeing
+   // the buffers the kernel writes into, a ring whose requests cannot be
+   // reaped is leaked instead
+   while ((ring->inflight))
+   {
+      if (*ring->cq_head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+      {
+         if ( (syscall(__NR_io_uring_enter, ring->fd, 0, (unsigned)ring->inflight, IORING_ENTER_GETEVENTS, NULL, 0) == -1) &&
+              (errno != EINTR) )
+            return;
+         continue;
+      };
+      __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+      ring->inflight--;
+   };
+
+   if ((ring->sqes))
+      munmap(ring->sqes, ring->sqes_len);
+   if ( ((ring->cq_ptr)) && (ring->cq_ptr != ring->sq_ptr) )
+      munmap(ring->cq_ptr, ring->cq_len);
+   if ((ring->sq_ptr))
+      munmap(ring->sq_ptr, ring->sq_len);
+   if (ring->fd != -1)
+      close(ring->fd);
+   free(ring->names);
+   free(ring);
+
+   return;
+}
+
+
+/// creates io_uring for a worker
+/// @param[in]  queue    queue of worker
+int walk_uring_init(WalkQueue * queue)
+{
+   char                    * sq;
+   char                    * cq;
+   WalkUring               * ring;
+   struct io_uring_params    params;
+
+   if (!(ring = calloc(1, sizeof(WalkUring))))
+      return(-1);
+   queue->uring = ring;
+
+   memset(&params, 0, sizeof(params));
+   if ((ring->fd = (int)syscall(__NR_io_uring_setup, WALK_URING_DEPTH, &params)) == -1)
+   {
+      walk_uring_free(queue);
+      return(-1);
+   };
+
+   // maps submission and completion queues
+   ring->sq_len = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+   ring->cq_len = params.cq_off.cqes  + (params.cq_entries * sizeof(struct io_uring_cqe));
+   if ((params.features & IORING_FEAT_SINGLE_MMAP))
+   {
+      ring->sq_len = (ring->cq_len > ring->sq_len) ? ring->cq_len : ring->sq_len;
+      ring->cq_len = ring->sq_len;
+   };
+   ring->sq_ptr = mmap(NULL, ring->sq_len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+   if (ring->sq_ptr == MAP_FAILED)
+   {
+      ring->sq_ptr = NULL;
+      walk_uring_free(queue);
+      return(-1);
+   };
+   ring->cq_ptr = ring->sq_ptr;
+   if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+   {
+      ring->cq_ptr = mmap(NULL, ring->cq_len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+      if (ring->cq_ptr == MAP_FAILED)
+      {
+         ring->cq_ptr = NULL;
+         walk_uring_free(queue);
+         return(-1);
+      };
+   };
+   ring->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+   ring->sqes     = mmap(NULL, ring->sqes_len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+   if (ring->sqes == MAP_FAILED)
+   {
+      ring->sqes = NULL;
+      walk_uring_free(queue);
+      return(-1);
+   };
+
+   sq             = ring->sq_ptr;
+   cq             = ring->cq_ptr;
+   ring->sq_head  = (unsigned *)(sq + params.sq_off.head);
+   ring->sq_tail  = (unsigned *)(sq + params.sq_off.tail);
+   ring->sq_mask  = (unsigned *)(sq + params.sq_off.ring_mask);
+   ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+   ring->cq_head  = (unsigned *)(cq + params.cq_off.head);
+   ring->cq_tail  = (unsigned *)(cq + params.cq_off.tail);
+   ring->cq_mask  = (unsigned *)(cq + params.cq_off.ring_mask);
+   ring->cqes     = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+   return(0);
+}
+
+
+/// converts statx results into stat data
+/// @param[in]  stx      results of statx request
+/// @param[in]  sb       stat data to populate
+void walk_uring_stat(const struct statx * stx, struct stat * sb)
+{
+   memset(sb, 0, sizeof(struct stat));
+   sb->st_dev          = makedev(stx->stx_dev_major, stx->stx_dev_minor);
+   sb->st_ino          = (ino_t)stx->stx_ino;
+   sb->st_mode         = (mode_t)stx->stx_mode;
+   sb->st_nlink        = (nlink_t)stx->stx_nlink;
+   sb->st_uid          = (uid_t)stx->stx_uid;
+   sb->st_gid          = (gid_t)stx->stx_gid;
+   sb->st_rdev         = makedev(stx->stx_rdev_major, stx->stx_rdev_minor);
+   sb->st_size         = (off_t)stx->stx_size;
+   sb->st_blksize      = (blksize_t)stx->stx_blksize;
+   sb->st_blocks       = (blkcnt_t)stx->stx_blocks;
+   sb->st_atime        = (time_t)stx->stx_atime.tv_sec;
+   sb->st_mtime        = (time_t)stx->stx_mtime.tv_sec;
+   sb->st_ctime        = (time_t)stx->stx_ctime.tv_sec;
+   return;
+}
+#endif
+
+
+/// records a file as visited and reports if it was visited before
+/// @param[in]  set      stripes of visited file set
+/// @param[in]  dev      device containing file
+/// @param[in]  ino      inode number of file
+int walk_visit(WalkInodes * set, dev_t dev, ino_t ino)
+{
+   size_t          u;
+   size_t          pos;
+   size_t          size;
+   uint64_t        hash;
+   WalkInode     * list;
+   WalkInodes    * stripe;
+
+   hash   = walk_hash(dev, ino);
+   stripe = &set[(hash >> 32) % WALK_INODE_LOCKS];
+
+   pthread_mutex_lock(&stripe->lock);
+
+   // grows table when more than half full
+   if ((stripe->count * 2) >= stripe->size)
+   {
+      size = ((stripe->size)) ? (stripe->size * 2) : 64;
+      if (!(list = calloc(size, sizeof(WalkInode))))
+      {
+         pthread_mutex_unlock(&stripe->lock);
+         return(-1);
+      };
+      for(u = 0; u < stripe->size; u++)
+      {
+         if (!(stripe->list[u].used))
+            continue;
+         pos = (size_t)walk_hash(stripe->list[u].dev, stripe->list[u].ino);
+         for(pos &= (size - 1); ((list[pos].used)); pos = (pos + 1) & (size - 1));
+         list[pos] = stripe->list[u];
+      };
+      free(stripe->list);
+      stripe->list = list;
+      stripe->size = size;
+   };
+
+   // searches for file and inserts it if not found
+   for(pos = (size_t)hash & (stripe->size - 1); ((stripe->list[pos].used)); pos = (pos + 1) & (stripe->size - 1))
+   {
+      if ( (stripe->list[pos].ino == ino) && (stripe->list[pos].dev == dev) )
+      {
+         pthread_mutex_unlock(&stripe->lock);
+         return(1);
+      };
+   };
+   stripe->list[pos].dev  = dev;
+   stripe->list[pos].ino  = ino;
+   stripe->list[pos].used = 1;
+   stripe->count++;
+
+   pthread_mutex_unlock(&stripe->lock);
+
+   return(0);
+}
+
+
+/// reads directories until the walk is complete
+/// @param[in]  arg      queue owned by worker
+void * walk_worker(void * arg)
+{
+   WalkQueue     * queue;
+   WalkState     * walk;
+   char          * dir;
+
+   queue = arg;
+   walk  = queue->walk;
+
+#ifdef WALK_URING
+   // falls back to fstatat() if io_uring is not supported by the kernel
+   if ((walk->cfg->opts & WALK_OPT_URING))
+      walk_uring_init(queue);
+#endif
+
+   while((dir = walk_take(walk, queue)))
+   {
+      walk_error(walk, walk_read(walk, queue, dir));
+      free(dir);
+      walk_finish(walk);
+   };
+
+   return(NULL);
+}
+
+/* end of source file */
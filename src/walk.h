@@ -0,0 +1,135 @@
+/*
+ *  DMS Tools and Utilities
+ *  Copyright (C) 2008 David M. Syzdek <david@syzdek.net>.
+ *
+ *  @SYZDEK_LICENSE_HEADER_START@
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of David M. Syzdek nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL DAVID M. SYZDEK BE LIABLE FOR
+ *  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ *  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ *  SUCH DAMAGE.
+ *
+ *  @SYZDEK_LICENSE_HEADER_END@
+ */
+/**
+ *  @file src/walk.h  directory tree walking library
+ */
+#ifndef _DMSTOOLS_SRC_WALK_H
+#define _DMSTOOLS_SRC_WALK_H 1
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+
+#ifndef PARAMS
+#define PARAMS(protos) protos
+#endif
+
+// walk options
+#define WALK_OPT_RECURSE     0x0001   ///< descend into directories
+#define WALK_OPT_HIDDEN      0x0002   ///< include entries whose names begin with a dot
+#define WALK_OPT_LINKS       0x0004   ///< follow symbolic links
+#define WALK_OPT_CONTINUE    0x0008   ///< continue after errors which are not fatal
+#define WALK_OPT_STAT        0x0010   ///< provide stat data for regular files
+#define WALK_OPT_URING       0x0020   ///< retrieve file status in batches with io_uring on Linux
+#define WALK_OPT_HARDLINKS   0x0040   ///< process files with several links only once
+
+// entry types passed to callbacks
+#define WALK_FILE            1        ///< regular file
+#define WALK_DIR             2        ///< directory which is about to be read
+#define WALK_LINK            3        ///< symbolic link which is not followed
+#define WALK_OTHER           4        ///< device, fifo, socket, or other special file
+#define WALK_ERROR           5        ///< entry could not be examined or read
+
+#define WALK_JOBS_MAX        256
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+
+typedef struct walk_config  WalkConfig;
+typedef struct walk_entry   WalkEntry;
+
+
+///////////////
+//           //
+//  Structs  //
+//           //
+///////////////
+
+/// entry passed to the callbacks of a walk
+struct walk_entry
+{
+   int                  type;    ///< WALK_* entry type
+   int                  err;     ///< errno value of WALK_ERROR entries
+   mode_t               mode;    ///< file type bits of st_mode, 0 if unknown
+   const char         * path;    ///< path of entry
+   const char         * name;    ///< last component of path
+   const struct stat  * sb;      ///< stat data, NULL unless retrieved
+};
+
+
+/// options and callbacks of a walk
+///
+/// The callback is invoked for each entry and returns 0 on success, -1 on
+/// a fatal error, or any other value on an error which stops the walk unless
+/// WALK_OPT_CONTINUE is set. The filter is invoked for each entry found in a
+/// directory before the entry is passed to the callback or, for directories,
+/// queued, and returns non-zero to skip the entry. When more than one job is
+/// requested, both may be invoked concurrently from several threads.
+struct walk_config
+{
+   int                  opts;    ///< WALK_OPT_* flags
+   unsigned             jobs;    ///< number of directories read in parallel
+   void               * data;    ///< data passed to callbacks
+   int               (* func)(const WalkEntry * entry, void * data);
+   int               (* filter)(const WalkEntry * entry, void * data);
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+
+// walks a file or directory tree and passes each entry to a callback
+int walk_tree PARAMS((const char * origin, const WalkConfig * cfg));
+
+#endif
+/* end of header */